@@ -697,7 +697,9 @@ def makeDistRoot(testSystem,
                  sync_start,
                  linkspeed,
                  linkdelay,
-                 dumpfile):
+                 dumpfile,
+                 transport = 'tcp',
+                 sync_adaptive = False):
     self = Root(full_system = True)
     self.testsys = testSystem
 
@@ -707,6 +709,8 @@ def makeDistRoot(testSystem,
                                    dist_size = size,
                                    server_name = server_name,
                                    server_port = server_port,
+                                   transport = transport,
+                                   dist_sync_adaptive = sync_adaptive,
                                    sync_start = sync_start,
                                    sync_repeat = sync_repeat)
 
@@ -248,6 +248,9 @@ def addCommonOptions(parser):
                       help="Parallel distributed gem5 simulation.")
     parser.add_option("--dist-sync-on-pseudo-op", action="store_true",
                       help="Use a pseudo-op to start dist-gem5 synchronization.")
+    parser.add_option("--dist-sync-adaptive", action="store_true",
+                      help="Skip dist-gem5 sync quanta in which no packet "\
+                      "can be sent (needed in all gem5 processes).")
     parser.add_option("--is-switch", action="store_true",
                       help="Select the network switch simulator process for a"\
                       "distributed gem5 run")
@@ -263,6 +266,11 @@ def addCommonOptions(parser):
                       default=2200,
                       action="store", type="int",
                       help="Message server listen port\nDEFAULT: 2200")
+    parser.add_option("--dist-transport",
+                      default="tcp", choices=["tcp", "shm"],
+                      action="store", type="choice",
+                      help="Transport between dist-gem5 processes, shm "\
+                      "needs all of them on the same host\nDEFAULT: tcp")
     parser.add_option("--dist-sync-repeat",
                       default="0us",
                       action="store", type="string",
@@ -53,6 +53,9 @@ def build_switch(options):
                                       dist_size = options.dist_size,
                                       server_name = options.dist_server_name,
                                       server_port = options.dist_server_port,
+                                      transport = options.dist_transport,
+                                      dist_sync_adaptive = \
+                                          options.dist_sync_adaptive,
                                       sync_start = options.dist_sync_start,
                                       sync_repeat = options.dist_sync_repeat,
                                       is_switch = True,
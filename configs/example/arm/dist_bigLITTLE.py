@@ -56,6 +56,9 @@ def addOptions(parser):
    # Options for distributed simulation (i.e. dist-gem5)
     parser.add_argument("--dist", action="store_true", help="Distributed gem5"\
                       " simulation.")
+    parser.add_argument("--dist-sync-adaptive", action="store_true",
+                        help="Skip dist-gem5 sync quanta in which no packet"\
+                      " can be sent (needed in all gem5 processes).")
     parser.add_argument("--is-switch", action="store_true",
                         help="Select the network switch simulator process for"\
                       " a distributed gem5 run.")
@@ -73,6 +76,11 @@ def addOptions(parser):
                       default=2200,
                       action="store", type=int,
                       help="Message server listen port\nDEFAULT: 2200")
+    parser.add_argument("--dist-transport",
+                      default="tcp", choices=["tcp", "shm"],
+                      action="store", type=str,
+                      help="Transport between dist-gem5 processes, shm"\
+                      " needs all of them on the same host\nDEFAULT: tcp")
     parser.add_argument("--dist-sync-repeat",
                       default="0us",
                       action="store", type=str,
@@ -112,6 +120,9 @@ def addEthernet(system, options):
                                      dist_size = options.dist_size,
                                      server_name = options.dist_server_name,
                                      server_port = options.dist_server_port,
+                                     transport = options.dist_transport,
+                                     dist_sync_adaptive = \
+                                         options.dist_sync_adaptive,
                                      sync_start = options.dist_sync_start,
                                      sync_repeat = options.dist_sync_repeat)
     system.etherlink.int0 = Parent.system.ethernet.interface
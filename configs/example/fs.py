@@ -152,6 +152,10 @@ def build_test_system(np):
         test_sys.kvm_vm = KvmVM()
 
     if options.ruby:
+        if options.ruby_event_queues > 1:
+            fatal("--ruby-event-queues is only supported in syscall "
+                  "emulation mode")
+
         bootmem = getattr(test_sys, '_bootmem', None)
         Ruby.create_system(options, True, test_sys, test_sys.iobus,
                            test_sys._dma_ports, bootmem)
@@ -354,7 +358,9 @@ elif len(bm) == 1 and options.dist:
                         options.dist_sync_start,
                         options.ethernet_linkspeed,
                         options.ethernet_linkdelay,
-                        options.etherdump);
+                        options.etherdump,
+                        options.dist_transport,
+                        options.dist_sync_adaptive);
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
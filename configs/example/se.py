@@ -434,4 +434,6 @@ else:
 #m5.stats.periodicStatDump(options.power_profile_initial_stats_interval)
 """1 000 000 000 000"""
 root = Root(full_system = False, system = system)
+if options.ruby:
+    Ruby.partition_event_queues(options, system, root)
 Simulation.run(options, root, system, FutureClass)
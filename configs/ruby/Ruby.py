@@ -82,6 +82,22 @@ def define_options(parser):
     parser.add_option("--recycle-latency", type="int", default=10,
                       help="Recycle latency for ruby controller input buffers")
 
+    parser.add_option("--ruby-fast-warmup", action="store_true",
+                      default=False,
+                      help="Restore Ruby caches from a checkpoint by "
+                           "installing lines directly when the protocol "
+                           "supports it")
+
+    parser.add_option("--ruby-event-queues", type="int", default=1,
+                      help="Number of event queues (host threads) the "
+                           "cache controllers are partitioned across "
+                           "(syscall emulation only)")
+    parser.add_option("--ruby-sim-quantum", type="string", default=None,
+                      help="Synchronization quantum when the Ruby "
+                           "controllers are partitioned; must not exceed "
+                           "the smallest controller-to-network latency, "
+                           "one Ruby clock cycle (default)")
+
     protocol = buildEnv['PROTOCOL']
     exec("from . import %s" % protocol)
     eval("%s.define_options(parser)" % protocol)
@@ -221,6 +237,7 @@ def create_system(options, full_system, system, piobus = None, dma_ports = [],
     ruby.number_of_virtual_networks = ruby.network.number_of_virtual_networks
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
+    ruby.fast_warmup = options.ruby_fast_warmup
 
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
@@ -228,6 +245,62 @@ def create_system(options, full_system, system, piobus = None, dma_ports = [],
         ruby.phys_mem = SimpleMemory(range=system.mem_ranges[0],
                                      in_addr_map=False)
 
+def partition_event_queues(options, system, root):
+    """ Distribute the cache controllers across several event queues.
+        Each cache controller, together with its sequencer, cache
+        memories and message buffers, is placed on one of the queues
+        1..N-1 and CPUs follow the controller owning their sequencer.
+        The network, directories and DMA controllers talk to memory
+        through ports and therefore stay on queue 0 with the rest of
+        the system. The controller/network MessageBuffers are the only
+        crossing points, so the smallest latency across them bounds
+        the simulation quantum. Both the controllers and the network
+        deliver messages at least one Ruby clock cycle after sending
+        them, so the quantum defaults to one cycle.
+
+        Functional accesses (e.g., from system calls) stop all event
+        queues while they walk the controllers, see RubyPort.
+
+        This is only supported in syscall emulation mode. In full
+        system mode the CPUs also talk to devices on queue 0 (e.g.,
+        through their interrupt controllers), which isn't safe across
+        queues.
+    """
+    num_queues = options.ruby_event_queues
+    if num_queues <= 1:
+        return
+
+    cntrls = [ obj for obj in system.ruby.descendants()
+               if isinstance(obj, RubyController) and
+               not obj.type.startswith(('Directory', 'DMA')) ]
+
+    for idx, cntrl in enumerate(cntrls):
+        for obj in cntrl.descendants():
+            obj.eventq_index = 1 + idx % (num_queues - 1)
+
+    for cpu, seq in zip(system.cpu, system.ruby._cpu_ports):
+        for obj in cpu.descendants():
+            obj.eventq_index = seq.eventq_index
+
+    # The quantum is a Tick parameter, so the latencies have to be
+    # converted before instantiation, which requires a fixed frequency.
+    m5.ticks.fixGlobalFrequency()
+    min_latency = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(options.ruby_clock))
+    if options.ruby_sim_quantum is None:
+        root.sim_quantum = min_latency
+        return
+
+    quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(options.ruby_sim_quantum))
+    if quantum > min_latency:
+        fatal("--ruby-sim-quantum (%s, %d ticks) exceeds the smallest "
+              "latency of messages between the controllers and the "
+              "network, one Ruby clock cycle (%d ticks at %s)",
+              options.ruby_sim_quantum, quantum, min_latency,
+              options.ruby_clock)
+    root.sim_quantum = quantum
+
 def create_directories(options, bootmem, ruby_system, system):
     dir_cntrl_nodes = []
     for i in range(options.num_dirs):
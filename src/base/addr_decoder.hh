@@ -0,0 +1,144 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_ADDR_DECODER_HH__
+#define __BASE_ADDR_DECODER_HH__
+
+#include <cstddef>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+
+/**
+ * Flat address decoder compiled from a set of non-overlapping address
+ * ranges, e.g., the contents of an AddrRangeMap.
+ *
+ * The ranges are stored as a sorted array of spans searched with a
+ * branch-free binary search. Interleaved ranges covering the same
+ * addresses form a single span with a table indexed by the value of
+ * the interleaving bits, so decoding an address striped over many
+ * channels costs the same as decoding a plain range. The decoder has
+ * to be rebuilt whenever the ranges change.
+ */
+template <typename V>
+class AddrDecoder
+{
+  public:
+    /**
+     * @param invalid Value returned for addresses without a range.
+     */
+    explicit AddrDecoder(const V &invalid) : invalid(invalid) {}
+
+    /**
+     * Rebuild the decoder from a sequence of (AddrRange, V) pairs
+     * sorted by start address, such as an AddrRangeMap.
+     *
+     * @param map Ranges to decode and their values
+     */
+    template <typename Map>
+    void
+    build(const Map &map)
+    {
+        spans.clear();
+        for (const auto &entry : map) {
+            const AddrRange &r = entry.first;
+            if (spans.empty() || !spans.back().range.mergesWith(r)) {
+                spans.push_back(Span{ r.start(), r.end(), r,
+                    std::vector<V>(r.stripes(), invalid) });
+            }
+            spans.back().values[r.getIntlvMatch()] = entry.second;
+        }
+    }
+
+    /**
+     * Find the value of the range containing an address range. The
+     * address range must not be interleaved.
+     *
+     * @param r Address range to decode
+     * @return The value of the range containing r, or the invalid value
+     */
+    const V &
+    find(const AddrRange &r) const
+    {
+        const Addr start = r.start();
+        const Addr last = r.end() - 1;
+
+        if (spans.empty() || start < spans[0].start)
+            return invalid;
+
+        // Find the last span starting at or before the address, the
+        // loop has a fixed trip count for a given number of spans
+        const Span *base = spans.data();
+        size_t n = spans.size();
+        while (n > 1) {
+            const size_t half = n / 2;
+            base = base[half].start <= start ? base + half : base;
+            n -= half;
+        }
+
+        const Span &span = *base;
+        if (r.end() > span.end)
+            return invalid;
+        if (!span.range.interleaved())
+            return span.values[0];
+
+        // Both ends have to be in the same stripe, and the range can't
+        // be larger than a contiguous chunk of it
+        const uint8_t match = span.range.intlvMatchOf(start);
+        if (last < span.start || last >= span.end ||
+            span.range.intlvMatchOf(last) != match ||
+            r.size() > span.range.granularity()) {
+            return invalid;
+        }
+        return span.values[match];
+    }
+
+    /**
+     * Find the value of the range containing an address.
+     *
+     * @param a Address to decode
+     * @return The value of the range containing a, or the invalid value
+     */
+    const V &find(Addr a) const { return find(RangeSize(a, 1)); }
+
+  private:
+    /** Addresses covered by a range or a group of interleaved ranges. */
+    struct Span
+    {
+        Addr start;
+        Addr end;
+        /** One of the ranges, for its interleaving function. */
+        AddrRange range;
+        /** Value of each stripe, indexed by the interleaving value. */
+        std::vector<V> values;
+    };
+
+    const V invalid;
+    std::vector<Span> spans;
+};
+
+#endif // __BASE_ADDR_DECODER_HH__
@@ -0,0 +1,118 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "base/addr_decoder.hh"
+#include "base/addr_range_map.hh"
+
+TEST(AddrDecoderTest, PlainRanges)
+{
+    AddrRangeMap<int> map;
+    map.insert(RangeIn(0x1000, 0x1fff), 1);
+    map.insert(RangeIn(0x4000, 0x4fff), 2);
+    map.insert(RangeIn(0x5000, 0x7fff), 3);
+
+    AddrDecoder<int> decoder(-1);
+    decoder.build(map);
+
+    EXPECT_EQ(-1, decoder.find(0x0));
+    EXPECT_EQ(1, decoder.find(0x1000));
+    EXPECT_EQ(1, decoder.find(0x1fff));
+    EXPECT_EQ(-1, decoder.find(0x2000));
+    EXPECT_EQ(2, decoder.find(0x4800));
+    EXPECT_EQ(3, decoder.find(0x5000));
+    EXPECT_EQ(-1, decoder.find(0x8000));
+
+    // Ranges have to be fully contained
+    EXPECT_EQ(1, decoder.find(RangeSize(0x1f00, 0x100)));
+    EXPECT_EQ(-1, decoder.find(RangeSize(0x1f00, 0x101)));
+    EXPECT_EQ(-1, decoder.find(RangeSize(0x4f00, 0x200)));
+}
+
+TEST(AddrDecoderTest, Empty)
+{
+    AddrRangeMap<int> map;
+    AddrDecoder<int> decoder(-1);
+    decoder.build(map);
+    EXPECT_EQ(-1, decoder.find(0x0));
+    EXPECT_EQ(-1, decoder.find(0x1234));
+}
+
+TEST(AddrDecoderTest, Interleaved)
+{
+    // Four channels interleaved at a 256 byte granularity, next to a
+    // plain range
+    AddrRangeMap<int> map;
+    for (int i = 0; i < 4; ++i) {
+        map.insert(AddrRange(0x10000, 0x20000,
+                             { ULL(1) << 8, ULL(1) << 9 }, i), i);
+    }
+    map.insert(RangeIn(0x20000, 0x2ffff), 4);
+
+    AddrDecoder<int> decoder(-1);
+    decoder.build(map);
+
+    EXPECT_EQ(-1, decoder.find(0xffff));
+    EXPECT_EQ(0, decoder.find(0x10000));
+    EXPECT_EQ(1, decoder.find(0x10100));
+    EXPECT_EQ(2, decoder.find(0x10200));
+    EXPECT_EQ(3, decoder.find(0x103ff));
+    EXPECT_EQ(0, decoder.find(0x10400));
+    EXPECT_EQ(4, decoder.find(0x20000));
+
+    EXPECT_EQ(1, decoder.find(RangeSize(0x10140, 0x40)));
+    // Crossing a stripe boundary
+    EXPECT_EQ(-1, decoder.find(RangeSize(0x101c0, 0x80)));
+}
+
+TEST(AddrDecoderTest, MatchesAddrRangeMap)
+{
+    // Two channels hashed with an xor of two bits, and plain ranges
+    AddrRangeMap<int> map;
+    for (int i = 0; i < 2; ++i) {
+        map.insert(AddrRange(0x100000, 0x200000,
+                             { (ULL(1) << 6) | (ULL(1) << 12) }, i), i);
+    }
+    map.insert(RangeIn(0x0, 0x3fff), 2);
+    map.insert(RangeIn(0x8000, 0xffff), 3);
+    map.insert(RangeIn(0x200000, 0x20ffff), 4);
+
+    AddrDecoder<int> decoder(-1);
+    decoder.build(map);
+
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 100000; ++i) {
+        const Addr addr = rng() % 0x220000;
+        const Addr size = 1 + rng() % 128;
+        const AddrRange r = RangeSize(addr, size);
+
+        auto it = map.contains(r);
+        EXPECT_EQ(it == map.end() ? -1 : it->second, decoder.find(r));
+    }
+}
@@ -410,20 +410,41 @@ class AddrRange
         // bits from the address match the interleaving value
         bool in_range = a >= _start && a < _end;
         if (in_range) {
-            auto sel = 0;
-            for (int i = 0; i < masks.size(); i++) {
-                Addr masked = a & masks[i];
-                // The result of an xor operation is 1 if the number
-                // of bits set is odd or 0 othersize, thefore it
-                // suffices to count the number of bits set to
-                // determine the i-th bit of sel.
-                sel |= (popCount(masked) % 2) << i;
-            }
-            return sel == intlvMatch;
+            return intlvMatchOf(a) == intlvMatch;
         }
         return false;
     }
 
+    /**
+     * Get the interleaving value of the range, i.e. the value the
+     * interleaving bits of an address in the range evaluate to.
+     *
+     * @return The interleaving value, 0 if the range isn't interleaved
+     */
+    uint8_t getIntlvMatch() const { return intlvMatch; }
+
+    /**
+     * Evaluate the interleaving bits of an address. The address is in
+     * the range if it is within its bounds and this matches the
+     * interleaving value of the range.
+     *
+     * @param a Address to evaluate
+     * @return The value of the interleaving bits of the address
+     */
+    uint8_t intlvMatchOf(Addr a) const
+    {
+        uint8_t sel = 0;
+        for (int i = 0; i < masks.size(); i++) {
+            Addr masked = a & masks[i];
+            // The result of an xor operation is 1 if the number
+            // of bits set is odd or 0 othersize, thefore it
+            // suffices to count the number of bits set to
+            // determine the i-th bit of sel.
+            sel |= (popCount(masked) % 2) << i;
+        }
+        return sel;
+    }
+
     /**
      * Remove the interleaving bits from an input address.
      *
@@ -0,0 +1,121 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "base/async_writer.hh"
+
+#include <algorithm>
+#include <cassert>
+
+AsyncWriter::AsyncWriter(Sink sink, size_t buffer_size, unsigned num_buffers)
+    : sink(sink), bufferSize(buffer_size), busy(false), stopping(false)
+{
+    assert(buffer_size > 0 && num_buffers >= 2);
+
+    for (unsigned i = 0; i < num_buffers; ++i) {
+        std::unique_ptr<Buffer> buffer(new Buffer);
+        buffer->data.reset(new char[bufferSize]);
+        buffer->size = 0;
+        if (i == 0)
+            current = std::move(buffer);
+        else
+            freeBuffers.push_back(std::move(buffer));
+    }
+
+    writer = std::thread(&AsyncWriter::writerLoop, this);
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queued.notify_one();
+    writer.join();
+}
+
+void
+AsyncWriter::writeSlow(const char *data, size_t size)
+{
+    while (size > 0) {
+        if (current->size == bufferSize)
+            submit();
+
+        const size_t chunk = std::min(size, bufferSize - current->size);
+        std::memcpy(current->data.get() + current->size, data, chunk);
+        current->size += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void
+AsyncWriter::submit()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    pending.push_back(std::move(current));
+    queued.notify_one();
+
+    written.wait(lock, [this] { return !freeBuffers.empty(); });
+    current = std::move(freeBuffers.back());
+    freeBuffers.pop_back();
+    current->size = 0;
+}
+
+void
+AsyncWriter::flush()
+{
+    if (current->size > 0)
+        submit();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [this] { return pending.empty() && !busy; });
+}
+
+void
+AsyncWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [this] { return !pending.empty() || stopping; });
+        if (pending.empty())
+            return;
+
+        std::unique_ptr<Buffer> buffer = std::move(pending.front());
+        pending.pop_front();
+        busy = true;
+
+        lock.unlock();
+        sink(buffer->data.get(), buffer->size);
+        lock.lock();
+
+        busy = false;
+        freeBuffers.push_back(std::move(buffer));
+        written.notify_all();
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_ASYNC_WRITER_HH__
+#define __BASE_ASYNC_WRITER_HH__
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Buffered writer that hands full buffers to a background thread.
+ *
+ * Data is copied into the current buffer without any locking. Once the
+ * buffer is full it is queued for the writer thread, which passes it on
+ * to the sink, and the producer continues with a free buffer. The
+ * number of buffers is fixed, so the memory used is bounded; if the sink
+ * can't keep up, the producer waits for a buffer to be written.
+ *
+ * The sink is only called from the writer thread, and nothing else may
+ * use the underlying output until flush() returns. A writer has a
+ * single producer: write() and flush() must be called from one thread
+ * at a time.
+ */
+class AsyncWriter
+{
+  public:
+    typedef std::function<void(const char *data, size_t size)> Sink;
+
+    /**
+     * @param sink Function called with every full buffer.
+     * @param buffer_size Size of each buffer in bytes.
+     * @param num_buffers Number of buffers, at least two.
+     */
+    AsyncWriter(Sink sink, size_t buffer_size = 1 << 20,
+                unsigned num_buffers = 2);
+
+    /** Write out all data and stop the writer thread. */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter &other) = delete;
+    AsyncWriter &operator=(const AsyncWriter &other) = delete;
+
+    void
+    write(const void *data, size_t size)
+    {
+        if (size <= bufferSize - current->size) {
+            std::memcpy(current->data.get() + current->size, data, size);
+            current->size += size;
+        } else {
+            writeSlow((const char *)data, size);
+        }
+    }
+
+    /**
+     * Hand the current buffer to the writer thread and wait until all
+     * data has been passed to the sink.
+     */
+    void flush();
+
+  private:
+    struct Buffer
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void writeSlow(const char *data, size_t size);
+
+    /** Queue the current buffer and wait for a free one. */
+    void submit();
+
+    void writerLoop();
+
+    const Sink sink;
+    const size_t bufferSize;
+
+    /** Buffer being filled, owned by the producer. */
+    std::unique_ptr<Buffer> current;
+
+    /** Everything below is protected by the mutex. */
+    std::mutex mutex;
+    /** Signalled when a buffer is queued or the writer should stop. */
+    std::condition_variable queued;
+    /** Signalled when a buffer has been written. */
+    std::condition_variable written;
+    std::deque<std::unique_ptr<Buffer>> pending;
+    std::vector<std::unique_ptr<Buffer>> freeBuffers;
+    /** Is the writer thread passing a buffer to the sink? */
+    bool busy;
+    bool stopping;
+
+    std::thread writer;
+};
+
+#endif // __BASE_ASYNC_WRITER_HH__
@@ -0,0 +1,96 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "base/async_writer.hh"
+
+TEST(AsyncWriterTest, WriteSmall)
+{
+    std::string out;
+    {
+        AsyncWriter writer([&](const char *data, size_t size) {
+            out.append(data, size);
+        }, 16);
+        writer.write("abc", 3);
+        writer.write("def", 3);
+    }
+    EXPECT_EQ("abcdef", out);
+}
+
+TEST(AsyncWriterTest, WriteLargerThanBuffer)
+{
+    std::string expected;
+    for (int i = 0; i < 1000; ++i)
+        expected += std::to_string(i) + ",";
+
+    std::string out;
+    {
+        AsyncWriter writer([&](const char *data, size_t size) {
+            EXPECT_LE(size, 7);
+            out.append(data, size);
+        }, 7, 3);
+        writer.write(expected.data(), expected.size());
+    }
+    EXPECT_EQ(expected, out);
+}
+
+TEST(AsyncWriterTest, Flush)
+{
+    std::string out;
+    AsyncWriter writer([&](const char *data, size_t size) {
+        out.append(data, size);
+    }, 1024);
+
+    writer.write("abc", 3);
+    writer.flush();
+    EXPECT_EQ("abc", out);
+
+    writer.write("def", 3);
+    writer.flush();
+    EXPECT_EQ("abcdef", out);
+}
+
+TEST(AsyncWriterTest, SlowSink)
+{
+    std::string expected;
+    std::string out;
+    {
+        AsyncWriter writer([&](const char *data, size_t size) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            out.append(data, size);
+        }, 8);
+        for (int i = 0; i < 200; ++i) {
+            const std::string s = std::to_string(i);
+            expected += s;
+            writer.write(s.data(), s.size());
+        }
+    }
+    EXPECT_EQ(expected, out);
+}
@@ -48,6 +48,12 @@
 
 const char* BmpWriter::_imgExtension = "bmp";
 
+const PixelConverter BmpWriter::pixelConverter(
+    4,        // 4 bytes / pixel
+    16, 8, 0, // R in [23, 16], G in [15, 8], B in [7, 0]
+    8, 8, 8,  // 8 bits / channel
+    LittleEndianByteOrder);
+
 // bitmap class ctor
 BmpWriter::BmpWriter(const FrameBuffer *_fb)
     : ImgWriter(_fb)
@@ -98,16 +104,39 @@ BmpWriter::write(std::ostream &bmp) const
     // 2.  write the bitmap data
     // BMP start store data left to right starting with the bottom row
     // so we need to do some creative flipping
-    std::vector<PixelType> line_buffer(fb.width());
-    for (int y = 0; y < fb.height(); ++y) {
-        for (unsigned x = 0; x < fb.width(); ++x)
-            line_buffer[x] = fb.pixel(x, fb.height() - y - 1);
+    std::vector<uint8_t> line_buffer(sizeof(PixelType) * fb.width());
+    for (int y = 0; y < fb.height(); ++y)
+        writeLine(bmp, fb.height() - y - 1, line_buffer);
 
-        bmp.write(reinterpret_cast<const char *>(line_buffer.data()),
-                  line_buffer.size() * sizeof(line_buffer[0]));
+    bmp.flush();
+}
+
+bool
+BmpWriter::writeChanges(std::ostream &bmp, uint64_t since) const
+{
+    const std::streamoff line_size(sizeof(PixelType) * fb.width());
+    std::vector<uint8_t> line_buffer(line_size);
+    for (unsigned y = 0; y < fb.height(); ++y) {
+        if (!fb.dirty(y, since))
+            continue;
+
+        bmp.seekp(sizeof(CompleteV1Header) +
+                  (fb.height() - y - 1) * line_size);
+        writeLine(bmp, y, line_buffer);
     }
 
     bmp.flush();
+    return true;
 }
 
+void
+BmpWriter::writeLine(std::ostream &bmp, unsigned y,
+                     std::vector<uint8_t> &line_buffer) const
+{
+    static_assert(sizeof(PixelType) == 4, "Unexpected BMP pixel size");
 
+    pixelConverter.fromPixels(line_buffer.data(),
+                              fb.pixels.data() + y * fb.width(), fb.width());
+    bmp.write(reinterpret_cast<const char *>(line_buffer.data()),
+              line_buffer.size());
+}
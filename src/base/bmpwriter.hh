@@ -43,6 +43,7 @@
 #define __BASE_BITMAP_HH__
 
 #include <ostream>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "base/framebuffer.hh"
@@ -79,6 +80,9 @@ class  BmpWriter : public ImgWriter
      */
     void write(std::ostream &bmp) const override;
 
+  protected:
+    bool writeChanges(std::ostream &bmp, uint64_t since) const override;
+
   private:
     struct FileHeader {
         unsigned char magic_number[2];
@@ -124,6 +128,20 @@ class  BmpWriter : public ImgWriter
 
     typedef BmpPixel32 PixelType;
 
+    /** Converter matching the layout of PixelType */
+    static const PixelConverter pixelConverter;
+
+    /**
+     * Write a line of the frame buffer at the current position in
+     * the stream.
+     *
+     * @param bmp stream to write to
+     * @param y line to write
+     * @param line_buffer scratch buffer holding a line of the image
+     */
+    void writeLine(std::ostream &bmp, unsigned y,
+                   std::vector<uint8_t> &line_buffer) const;
+
     static const char* _imgExtension;
 
     const CompleteV1Header getCompleteHeader() const;
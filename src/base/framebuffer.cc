@@ -41,19 +41,23 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "base/bitfield.hh"
 
 const FrameBuffer FrameBuffer::dummy(320, 240);
 
 FrameBuffer::FrameBuffer(unsigned width, unsigned height)
     : pixels(width * height),
-      _width(width), _height(height)
+      _width(width), _height(height),
+      _version(0), lineVersions(height, 0)
 {
     clear();
 }
 
 FrameBuffer::FrameBuffer()
-    : _width(0), _height(0)
+    : _width(0), _height(0), _version(0)
 {
 }
 
@@ -76,6 +80,9 @@ FrameBuffer::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_width);
     UNSERIALIZE_SCALAR(_height);
     UNSERIALIZE_CONTAINER(pixels);
+
+    lineVersions.resize(_height);
+    markDirty();
 }
 
 void
@@ -85,6 +92,8 @@ FrameBuffer::resize(unsigned width, unsigned height)
     _height = height;
 
     pixels.resize(width * height);
+    lineVersions.resize(height);
+    markDirty();
 }
 
 void
@@ -92,6 +101,8 @@ FrameBuffer::fill(const Pixel &pixel)
 {
     for (auto &p : pixels)
         p = pixel;
+
+    markDirty();
 }
 
 void
@@ -105,21 +116,59 @@ FrameBuffer::clear()
 void
 FrameBuffer::copyIn(const uint8_t *fb, const PixelConverter &conv)
 {
-    for (auto &p : pixels) {
-        p = conv.toPixel(fb);
-        fb += conv.length;
+    // Convert a line at a time to be able to tell which lines changed
+    std::vector<Pixel> line(_width);
+    for (unsigned y = 0; y < _height; ++y) {
+        conv.toPixels(fb, line.data(), _width);
+        setPixels(0, y, line.data(), _width);
+        fb += _width * conv.length;
     }
 }
 
+std::vector<FrameBuffer::LineRun>
+FrameBuffer::dirtyRuns(uint64_t since) const
+{
+    std::vector<LineRun> runs;
+    for (unsigned y = 0; y < _height; ++y) {
+        if (!dirty(y, since))
+            continue;
+
+        if (!runs.empty() && runs.back().second == y)
+            runs.back().second = y + 1;
+        else
+            runs.emplace_back(y, y + 1);
+    }
+
+    return runs;
+}
+
 void
 FrameBuffer::copyOut(uint8_t *fb, const PixelConverter &conv) const
 {
-    for (auto &p : pixels) {
-        conv.fromPixel(fb, p);
-        fb += conv.length;
+    conv.fromPixels(fb, pixels.data(), area());
+}
+
+void
+FrameBuffer::setPixels(unsigned x, unsigned y, const Pixel *src,
+                       unsigned count)
+{
+    assert(x + count <= _width);
+    assert(y < _height);
+
+    Pixel *dst(pixels.data() + y * _width + x);
+    if (std::memcmp(dst, src, count * sizeof(Pixel)) != 0) {
+        std::copy(src, src + count, dst);
+        markDirty(y);
     }
 }
 
+void
+FrameBuffer::markDirty()
+{
+    ++_version;
+    std::fill(lineVersions.begin(), lineVersions.end(), _version);
+}
+
 uint64_t
 FrameBuffer::getHash() const
 {
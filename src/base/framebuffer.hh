@@ -40,10 +40,12 @@
 #ifndef __BASE_FRAMEBUFFER_HH__
 #define __BASE_FRAMEBUFFER_HH__
 
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/compiler.hh"
@@ -63,6 +65,15 @@
  * image. That is, the pixel at position (0, 0) is the upper left
  * corner. The backing store is a linear vector of Pixels ordered left
  * to right starting in the upper left corner.
+ *
+ * The frame buffer keeps track of which lines changed to let
+ * consumers (e.g., VNC and image dumps) only process the parts of the
+ * image that were updated. Every time a line is marked as dirty, it
+ * is tagged with a new version number. A consumer remembers the
+ * version() it last looked at and asks for the lines that have
+ * changed since. The copyIn() and setPixels() methods only mark lines
+ * that actually changed. Code writing pixels directly using pixel()
+ * or the backing store needs to call markDirty() itself.
  */
 class FrameBuffer : public Serializable
 {
@@ -176,6 +187,62 @@ class FrameBuffer : public Serializable
         return pixels[y * _width + x];
     }
 
+    /**
+     * Store a run of pixels on a line.
+     *
+     * The line is only marked as dirty if the new pixels differ from
+     * the ones already in the frame buffer.
+     *
+     * @param x Distance from the left margin of the first pixel.
+     * @param y Distance from the top of the frame.
+     * @param src Pixels to store.
+     * @param count Number of pixels to store.
+     */
+    void setPixels(unsigned x, unsigned y, const Pixel *src, unsigned count);
+
+    /**
+     * Mark a line as changed.
+     *
+     * @param y Distance from the top of the frame.
+     */
+    void markDirty(unsigned y) {
+        assert(y < _height);
+
+        lineVersions[y] = ++_version;
+    }
+    /** Mark the whole frame buffer as changed. */
+    void markDirty();
+
+    /**
+     * Version of the frame buffer contents. It increases every time
+     * a line is marked as dirty.
+     */
+    uint64_t version() const { return _version; }
+
+    /**
+     * Has a line changed after a given version?
+     *
+     * @param y Distance from the top of the frame.
+     * @param since Version the caller last looked at.
+     */
+    bool dirty(unsigned y, uint64_t since) const {
+        assert(y < _height);
+
+        return lineVersions[y] > since;
+    }
+
+    /** A run of lines: the first line and one past the last line */
+    typedef std::pair<unsigned, unsigned> LineRun;
+
+    /**
+     * Find the runs of adjacent lines that changed after a given
+     * version.
+     *
+     * @param since Version the caller last looked at.
+     * @return Runs of dirty lines ordered from the top of the frame.
+     */
+    std::vector<LineRun> dirtyRuns(uint64_t since) const;
+
     /**
      * Create a hash of the image that can be used for quick
      * comparisons.
@@ -198,6 +265,11 @@ class FrameBuffer : public Serializable
     unsigned _width;
     /** Height in pixels */
     unsigned _height;
+
+    /** Version of the last change */
+    uint64_t _version;
+    /** Version of the last change to each line */
+    std::vector<uint64_t> lineVersions;
 };
 
 #endif // __BASE_FRAMEBUFFER_HH__
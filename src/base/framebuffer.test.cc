@@ -0,0 +1,253 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/bmpwriter.hh"
+#include "base/framebuffer.hh"
+#include "sim/sim_object.hh"
+
+static const Pixel pixel_red(0xff, 0x00, 0x00);
+static const Pixel pixel_green(0x00, 0xff, 0x00);
+
+/** Number of lines that changed after a given version */
+static unsigned
+dirtyLines(const FrameBuffer &fb, uint64_t since)
+{
+    unsigned count = 0;
+    for (unsigned y = 0; y < fb.height(); ++y)
+        count += fb.dirty(y, since);
+    return count;
+}
+
+TEST(FrameBufferTest, ResizeMarksAllDirty)
+{
+    FrameBuffer fb(8, 4);
+    const uint64_t version = fb.version();
+
+    fb.resize(16, 6);
+    EXPECT_GT(fb.version(), version);
+    EXPECT_EQ(dirtyLines(fb, version), 6);
+    EXPECT_EQ(dirtyLines(fb, fb.version()), 0);
+}
+
+TEST(FrameBufferTest, SetPixelsMarksChangedLines)
+{
+    FrameBuffer fb(8, 4);
+    const std::vector<Pixel> run(3, pixel_red);
+
+    const uint64_t version = fb.version();
+    fb.setPixels(2, 1, run.data(), run.size());
+    EXPECT_GT(fb.version(), version);
+    EXPECT_EQ(dirtyLines(fb, version), 1);
+    EXPECT_TRUE(fb.dirty(1, version));
+    EXPECT_EQ(fb.pixel(2, 1), pixel_red);
+    EXPECT_EQ(fb.pixel(4, 1), pixel_red);
+
+    // Writing the same pixels again doesn't change anything.
+    const uint64_t unchanged = fb.version();
+    fb.setPixels(2, 1, run.data(), run.size());
+    EXPECT_EQ(fb.version(), unchanged);
+    EXPECT_EQ(dirtyLines(fb, unchanged), 0);
+}
+
+TEST(FrameBufferTest, CopyInMarksChangedLines)
+{
+    FrameBuffer fb(8, 4);
+    fb.fill(pixel_green);
+
+    std::vector<uint8_t> ext(fb.area() * PixelConverter::rgba8888_le.length);
+    fb.copyOut(ext, PixelConverter::rgba8888_le);
+
+    const uint64_t version = fb.version();
+    fb.copyIn(ext, PixelConverter::rgba8888_le);
+    EXPECT_EQ(fb.version(), version);
+
+    // Change the first pixel on line 2.
+    PixelConverter::rgba8888_le.fromPixels(
+        ext.data() + 2 * fb.width() * PixelConverter::rgba8888_le.length,
+        &pixel_red, 1);
+    fb.copyIn(ext, PixelConverter::rgba8888_le);
+    EXPECT_EQ(dirtyLines(fb, version), 1);
+    EXPECT_TRUE(fb.dirty(2, version));
+    EXPECT_EQ(fb.pixel(0, 2), pixel_red);
+}
+
+TEST(FrameBufferTest, MarkDirty)
+{
+    FrameBuffer fb(8, 4);
+
+    const uint64_t version = fb.version();
+    fb.markDirty(3);
+    EXPECT_EQ(dirtyLines(fb, version), 1);
+    EXPECT_TRUE(fb.dirty(3, version));
+
+    const uint64_t line_version = fb.version();
+    fb.markDirty();
+    EXPECT_EQ(dirtyLines(fb, line_version), 4);
+}
+
+TEST(FrameBufferTest, DirtyRuns)
+{
+    FrameBuffer fb(8, 10);
+    const std::vector<Pixel> run(2, pixel_red);
+    typedef FrameBuffer::LineRun LineRun;
+
+    const uint64_t version = fb.version();
+    EXPECT_TRUE(fb.dirtyRuns(version).empty());
+
+    // Adjacent lines are merged into a single run.
+    for (unsigned y : { 0, 3, 4, 5, 9 })
+        fb.setPixels(1, y, run.data(), run.size());
+    EXPECT_EQ(fb.dirtyRuns(version),
+              std::vector<LineRun>({ LineRun(0, 1), LineRun(3, 6),
+                                     LineRun(9, 10) }));
+
+    // Only lines changed after the given version are reported.
+    const uint64_t later = fb.version();
+    fb.setPixels(0, 7, run.data(), run.size());
+    fb.markDirty(8);
+    EXPECT_EQ(fb.dirtyRuns(later),
+              std::vector<LineRun>({ LineRun(7, 9) }));
+
+    fb.markDirty();
+    EXPECT_EQ(fb.dirtyRuns(later),
+              std::vector<LineRun>({ LineRun(0, 10) }));
+}
+
+TEST(FrameBufferTest, UnserializeMarksAllDirty)
+{
+    char tmpl[] = "/tmp/gem5-fb-test.XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    const std::string dir(tmpl);
+    const std::string cpt_file(dir + "/" + CheckpointIn::baseFilename);
+
+    FrameBuffer fb(4, 3);
+    fb.fill(pixel_red);
+    {
+        std::ofstream cpt(cpt_file);
+        fb.serializeSection(cpt, "fb");
+    }
+
+    class NoResolver : public SimObjectResolver
+    {
+      public:
+        SimObject *resolveSimObject(const std::string &name) override
+        {
+            return nullptr;
+        }
+    } resolver;
+
+    FrameBuffer restored(4, 3);
+    const uint64_t version = restored.version();
+    {
+        CheckpointIn cpt(dir, resolver);
+        restored.unserializeSection(cpt, "fb");
+    }
+    std::remove(cpt_file.c_str());
+    rmdir(dir.c_str());
+
+    EXPECT_EQ(restored.pixels, fb.pixels);
+    EXPECT_EQ(dirtyLines(restored, version), 3);
+}
+
+TEST(BmpWriterTest, UpdateUnchanged)
+{
+    FrameBuffer fb(8, 4);
+    BmpWriter writer(&fb);
+    std::stringstream bmp;
+
+    writer.update(bmp);
+    const std::string image(bmp.str());
+    EXPECT_FALSE(image.empty());
+
+    // Nothing is written if the frame buffer didn't change.
+    const std::string marker(image.size(), 'x');
+    bmp.str(marker);
+    writer.update(bmp);
+    EXPECT_EQ(bmp.str(), marker);
+}
+
+TEST(BmpWriterTest, UpdateChangedLines)
+{
+    FrameBuffer fb(37, 11);
+    BmpWriter writer(&fb);
+    std::stringstream bmp;
+    writer.update(bmp);
+
+    const std::vector<Pixel> run(5, pixel_red);
+    fb.setPixels(3, 4, run.data(), run.size());
+    fb.setPixels(0, 9, run.data(), run.size());
+    writer.update(bmp);
+
+    // The patched image matches a fresh write.
+    std::stringstream fresh;
+    writer.write(fresh);
+    EXPECT_EQ(bmp.str(), fresh.str());
+
+    // Only the lines that changed are rewritten. Scribble over the
+    // image, change a line, and check that the rest is left alone.
+    const std::string image(bmp.str());
+    bmp.str(std::string(image.size(), 'x'));
+    fb.setPixels(0, 0, run.data(), run.size());
+    writer.update(bmp);
+
+    // Bitmaps are stored bottom up, so line 0 is last.
+    const size_t line_size(fb.width() * 4);
+    const std::string updated(bmp.str());
+    ASSERT_EQ(updated.size(), image.size());
+    EXPECT_EQ(updated.substr(0, image.size() - line_size),
+              std::string(image.size() - line_size, 'x'));
+    std::stringstream fresh_line;
+    writer.write(fresh_line);
+    EXPECT_EQ(updated.substr(image.size() - line_size),
+              fresh_line.str().substr(image.size() - line_size));
+}
+
+TEST(BmpWriterTest, UpdateResized)
+{
+    FrameBuffer fb(8, 4);
+    BmpWriter writer(&fb);
+    std::stringstream bmp;
+    writer.update(bmp);
+
+    // A new size needs a new header, so the whole image is rewritten.
+    fb.resize(16, 2);
+    fb.fill(pixel_green);
+    std::stringstream resized;
+    writer.update(resized);
+
+    std::stringstream fresh;
+    writer.write(fresh);
+    EXPECT_EQ(resized.str(), fresh.str());
+}
@@ -48,6 +48,26 @@
 
 #endif
 
+void
+ImgWriter::update(std::ostream &out)
+{
+    const bool same_size(updated &&
+                         fb.width() == updateWidth &&
+                         fb.height() == updateHeight);
+    if (same_size && fb.version() == updateVersion)
+        return;
+
+    if (!same_size || !writeChanges(out, updateVersion)) {
+        out.seekp(0);
+        write(out);
+    }
+
+    updated = true;
+    updateVersion = fb.version();
+    updateWidth = fb.width();
+    updateHeight = fb.height();
+}
+
 std::unique_ptr<ImgWriter>
 createImgWriter(Enums::ImageFormat type, const FrameBuffer *fb)
 {
@@ -51,7 +51,8 @@ class ImgWriter
 {
   public:
     ImgWriter(const FrameBuffer *_fb)
-      : fb(*_fb)
+      : fb(*_fb), updated(false), updateVersion(0),
+        updateWidth(0), updateHeight(0)
     {}
 
     virtual ~ImgWriter() {};
@@ -61,6 +62,18 @@ class ImgWriter
      * @param out output stream to write to
      */
     virtual void write(std::ostream &out) const = 0;
+    /**
+     * Bring an image previously written to the provided ostream by
+     * this method up to date with the frame buffer.
+     *
+     * Nothing is written if the frame buffer hasn't changed since the
+     * last update. Writers that can patch an image in place only
+     * overwrite the lines that changed, others rewrite the whole
+     * image from the beginning of the stream.
+     *
+     * @param out output stream to update
+     */
+    void update(std::ostream &out);
     /*
      * Return Image format as a string
      *
@@ -69,7 +82,27 @@ class ImgWriter
     virtual const char* getImgExtension() const = 0;
 
   protected:
+    /**
+     * Overwrite the lines that changed after a given version of the
+     * frame buffer in an image of the same size.
+     *
+     * @param out output stream holding the image
+     * @param since frame buffer version of the image
+     * @return false if the image can't be updated in place
+     */
+    virtual bool writeChanges(std::ostream &out, uint64_t since) const {
+        return false;
+    }
+
     const FrameBuffer &fb;
+
+  private:
+    /** Has update() been called before? */
+    bool updated;
+    /** Frame buffer version and size at the last update */
+    uint64_t updateVersion;
+    unsigned updateWidth;
+    unsigned updateHeight;
 };
 
 /**
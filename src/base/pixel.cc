@@ -41,6 +41,10 @@
 
 #include <cassert>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "base/bitfield.hh"
 
 const PixelConverter PixelConverter::rgba8888_le(4, 0, 8, 16, 8, 8, 8);
@@ -98,3 +102,100 @@ PixelConverter::writeWord(uint8_t *p, uint32_t word) const
             p[i] = (word >> (8 * (length - i - 1))) & 0xFF;
     }
 }
+
+bool
+PixelConverter::byteChannels(unsigned &r, unsigned &g, unsigned &b) const
+{
+    if (length != 4)
+        return false;
+
+    const Channel *channels[] = { &ch_r, &ch_g, &ch_b };
+    unsigned *bytes[] = { &r, &g, &b };
+    for (int i = 0; i < 3; ++i) {
+        const Channel &ch(*channels[i]);
+        if (ch.mask != 0xFF || ch.offset % 8 != 0 || ch.offset > 24)
+            return false;
+
+        *bytes[i] = byte_order == LittleEndianByteOrder ?
+            ch.offset / 8 : 3 - ch.offset / 8;
+    }
+
+    return r != g && r != b && g != b;
+}
+
+void
+PixelConverter::toPixels(const uint8_t *rfb, Pixel *pixels,
+                         size_t count) const
+{
+    unsigned r, g, b;
+    if (!byteChannels(r, g, b)) {
+        for (size_t i = 0; i < count; ++i, rfb += length)
+            pixels[i] = toPixel(rfb);
+        return;
+    }
+
+    // An 8-bit channel doesn't need any scaling, so converting a word
+    // is just a matter of moving its bytes around.
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Treat four words as little-endian 32-bit lanes, which matches
+    // the in-memory layout of four Pixels on x86.
+    const __m128i byte_mask(_mm_set1_epi32(0xFF));
+    const __m128i r_shift(_mm_cvtsi32_si128(8 * r));
+    const __m128i g_shift(_mm_cvtsi32_si128(8 * g));
+    const __m128i b_shift(_mm_cvtsi32_si128(8 * b));
+    for (; i + 4 <= count; i += 4, rfb += 16) {
+        const __m128i words(_mm_loadu_si128((const __m128i *)rfb));
+        const __m128i red(
+            _mm_and_si128(_mm_srl_epi32(words, r_shift), byte_mask));
+        const __m128i green(
+            _mm_and_si128(_mm_srl_epi32(words, g_shift), byte_mask));
+        const __m128i blue(
+            _mm_and_si128(_mm_srl_epi32(words, b_shift), byte_mask));
+        _mm_storeu_si128((__m128i *)(pixels + i),
+                         _mm_or_si128(red,
+                             _mm_or_si128(_mm_slli_epi32(green, 8),
+                                          _mm_slli_epi32(blue, 16))));
+    }
+#endif
+    for (; i < count; ++i, rfb += 4)
+        pixels[i] = Pixel(rfb[r], rfb[g], rfb[b]);
+}
+
+void
+PixelConverter::fromPixels(uint8_t *rfb, const Pixel *pixels,
+                           size_t count) const
+{
+    unsigned r, g, b;
+    if (!byteChannels(r, g, b)) {
+        for (size_t i = 0; i < count; ++i, rfb += length)
+            fromPixel(rfb, pixels[i]);
+        return;
+    }
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i byte_mask(_mm_set1_epi32(0xFF));
+    const __m128i r_shift(_mm_cvtsi32_si128(8 * r));
+    const __m128i g_shift(_mm_cvtsi32_si128(8 * g));
+    const __m128i b_shift(_mm_cvtsi32_si128(8 * b));
+    for (; i + 4 <= count; i += 4, rfb += 16) {
+        const __m128i pxls(_mm_loadu_si128((const __m128i *)(pixels + i)));
+        const __m128i red(_mm_and_si128(pxls, byte_mask));
+        const __m128i green(
+            _mm_and_si128(_mm_srli_epi32(pxls, 8), byte_mask));
+        const __m128i blue(
+            _mm_and_si128(_mm_srli_epi32(pxls, 16), byte_mask));
+        _mm_storeu_si128((__m128i *)rfb,
+                         _mm_or_si128(_mm_sll_epi32(red, r_shift),
+                             _mm_or_si128(_mm_sll_epi32(green, g_shift),
+                                          _mm_sll_epi32(blue, b_shift))));
+    }
+#endif
+    for (; i < count; ++i, rfb += 4) {
+        rfb[0] = rfb[1] = rfb[2] = rfb[3] = 0;
+        rfb[r] = pixels[i].red;
+        rfb[g] = pixels[i].green;
+        rfb[b] = pixels[i].blue;
+    }
+}
@@ -67,6 +67,8 @@ struct Pixel
     uint8_t padding;
 };
 
+static_assert(sizeof(Pixel) == 4, "Pixels are expected to be 32 bits");
+
 inline bool
 operator==(const Pixel &lhs, const Pixel &rhs)
 {
@@ -158,6 +160,29 @@ class PixelConverter
         writeWord(rfb, fromPixel(pixel));
     }
 
+    /**
+     * Convert a sequence of color words in memory into Pixels.
+     *
+     * This is equivalent to calling toPixel() on every word, but
+     * 32-bit formats with 8-bit channels are converted as byte
+     * shuffles, several pixels at a time where SIMD is available.
+     *
+     * @param rfb Pointer to the first word in memory.
+     * @param pixels Output pixels.
+     * @param count Number of pixels to convert.
+     */
+    void toPixels(const uint8_t *rfb, Pixel *pixels, size_t count) const;
+    /**
+     * Convert a sequence of Pixels into color words in memory.
+     *
+     * @see toPixels()
+     *
+     * @param rfb Pointer to the first word in memory.
+     * @param pixels Pixels to convert.
+     * @param count Number of pixels to convert.
+     */
+    void fromPixels(uint8_t *rfb, const Pixel *pixels, size_t count) const;
+
     /**
      * Read a word of a given length and endianness from memory.
      *
@@ -177,6 +202,17 @@ class PixelConverter
      */
     void writeWord(uint8_t *p, uint32_t word) const;
 
+  protected:
+    /**
+     * Get the position in memory of every channel if the color words
+     * are 32 bits wide and all channels are byte-aligned 8-bit
+     * fields.
+     *
+     * @return true if the fast conversion path can be used.
+     */
+    bool byteChannels(unsigned &r, unsigned &g, unsigned &b) const;
+
+  public:
     /** Bytes per pixel when stored in memory (including padding) */
     unsigned length;
     /**
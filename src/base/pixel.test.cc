@@ -119,3 +119,37 @@ TEST(FBTest, MemToPixelRGBA8888BE)
     EXPECT_EQ(PixelConverter::rgba8888_be.toPixel(green), pixel_green);
     EXPECT_EQ(PixelConverter::rgba8888_be.toPixel(blue), pixel_blue);
 }
+
+static void
+checkBulkConversion(const PixelConverter &conv)
+{
+    // Odd number of pixels to exercise the tail of vectorized loops
+    const size_t count(37);
+    std::vector<Pixel> pixels(count);
+    for (size_t i = 0; i < count; ++i)
+        pixels[i] = Pixel(i * 7, 255 - i * 3, i * 13);
+
+    std::vector<uint8_t> bulk(count * conv.length, 0xa5);
+    std::vector<uint8_t> single(count * conv.length, 0x5a);
+    conv.fromPixels(bulk.data(), pixels.data(), count);
+    for (size_t i = 0; i < count; ++i)
+        conv.fromPixel(single.data() + i * conv.length, pixels[i]);
+    EXPECT_EQ(bulk, single);
+
+    std::vector<Pixel> converted(count);
+    conv.toPixels(bulk.data(), converted.data(), count);
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(converted[i], conv.toPixel(bulk.data() + i * conv.length));
+}
+
+TEST(FBTest, BulkConversion)
+{
+    checkBulkConversion(PixelConverter::rgba8888_le);
+    checkBulkConversion(PixelConverter::rgba8888_be);
+    checkBulkConversion(PixelConverter::rgb565_le);
+    checkBulkConversion(PixelConverter::rgb565_be);
+    // BGR with 8-bit channels, e.g., the VNC pixel format
+    checkBulkConversion(PixelConverter(4, 16, 8, 0, 8, 8, 8));
+    checkBulkConversion(
+        PixelConverter(4, 24, 16, 8, 8, 8, 8, BigEndianByteOrder));
+}
@@ -135,6 +135,20 @@ class RefCountingPtr
             RefCountingPtr<T>>::type;
     friend NonConstT;
     /** @} */
+
+    /**
+     * Pointers to classes derived from T can be converted into this
+     * pointer type. The const/non-const conversions are handled
+     * separately above.
+     */
+    template <class U>
+    using EnableIfDerived = typename std::enable_if<
+        std::is_convertible<U *, T *>::value &&
+        !std::is_same<typename std::remove_const<U>::type,
+                      typename std::remove_const<T>::type>::value>::type;
+    template <class U>
+    friend class RefCountingPtr;
+
     /// The stored pointer.
     /// Arguably this should be private.
     T *data;
@@ -204,6 +218,21 @@ class RefCountingPtr
     template <bool B = TisConst>
     RefCountingPtr(const NonConstT &r) { copy(r.data); }
 
+    /// Create a reference counting pointer to a base class of the
+    /// object referenced by another pointer. Adds a reference.
+    template <class U, typename = EnableIfDerived<U>>
+    RefCountingPtr(const RefCountingPtr<U> &r) { copy(r.data); }
+
+    /** Move-construct from a pointer to a derived class.
+     * Does not add a reference.
+     */
+    template <class U, typename = EnableIfDerived<U>>
+    RefCountingPtr(RefCountingPtr<U> &&r)
+    {
+        data = r.data;
+        r.data = nullptr;
+    }
+
     /// Destroy the pointer and any reference it may hold.
     ~RefCountingPtr() { del(); }
 
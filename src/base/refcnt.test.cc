@@ -35,6 +35,7 @@
 #include <gtest/gtest.h>
 
 #include <list>
+#include <utility>
 
 #include "base/refcnt.hh"
 
@@ -173,4 +174,29 @@ TEST(RefcntTest, EqualityOperators)
     EXPECT_TRUE(equalTestA != equalTestBPtr);
     EXPECT_TRUE(equalTestAPtr != equalTestB);
     EXPECT_TRUE(equalTestAPtr != equalTestBPtr);
-}
\ No newline at end of file
+}
+
+TEST(RefcntTest, ConversionToBaseClass)
+{
+    class DerivedRC : public TestRC {};
+
+    // Copying to a base class pointer adds a reference.
+    RefCountingPtr<DerivedRC> derivedPtr = new DerivedRC();
+    Ptr basePtr = derivedPtr;
+    EXPECT_EQ(basePtr.get(), derivedPtr.get());
+    EXPECT_EQ(1, liveListSize());
+    derivedPtr = nullptr;
+    EXPECT_EQ(1, liveListSize());
+    basePtr = nullptr;
+    EXPECT_EQ(0, liveListSize());
+
+    // Moving to a base class pointer transfers the reference.
+    RefCountingPtr<DerivedRC> movedPtr = new DerivedRC();
+    DerivedRC *object = movedPtr.get();
+    Ptr movedBasePtr = std::move(movedPtr);
+    EXPECT_FALSE(movedPtr);
+    EXPECT_EQ(object, movedBasePtr.get());
+    EXPECT_EQ(1, liveListSize());
+    movedBasePtr = nullptr;
+    EXPECT_EQ(0, liveListSize());
+}
@@ -0,0 +1,352 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <cmath>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
+
+namespace Stats {
+
+namespace {
+
+/**
+ * Labels for the elements of a vector-like stat: the subnames if there
+ * are any, otherwise the element indices.
+ */
+std::vector<std::string>
+elementLabels(const std::vector<std::string> &subnames, size_t size)
+{
+    std::vector<std::string> labels(size);
+    for (size_t i = 0; i < size; ++i) {
+        if (i < subnames.size() && !subnames[i].empty())
+            labels[i] = subnames[i];
+        else
+            labels[i] = std::to_string(i);
+    }
+    return labels;
+}
+
+/** Integral values that survive a round trip through an int64_t. */
+bool
+isIntegral(double value)
+{
+    // NaNs fail both comparisons.
+    return std::fabs(value) < 9007199254740992.0 &&
+        value == std::trunc(value);
+}
+
+} // anonymous namespace
+
+const char Binary::magic[8] = { 'g', 'e', 'm', '5', 's', 't', 'a', 't' };
+
+Binary::Binary(const std::string &filename, bool delta)
+    : file(simout.create(filename, true, true)), stream(file->stream()),
+      delta(delta), statIdx(0), schemaChanged(false)
+{
+    if (!valid())
+        fatal("Unable to open statistics file '%s' for writing\n", filename);
+
+    buffer.clear();
+    put(magic, sizeof(magic));
+    putU32(version);
+    buffer.push_back(delta ? 1 : 0);
+    stream->write((const char *)buffer.data(), buffer.size());
+}
+
+Binary::~Binary()
+{
+    simout.close(file);
+}
+
+std::string
+Binary::begin()
+{
+    assert(path.empty());
+    statIdx = 0;
+    schemaChanged = false;
+    values.clear();
+    return "";
+}
+
+std::string
+Binary::end()
+{
+    // Stats at the end of the schema that weren't visited this time.
+    if (statIdx != schema.size()) {
+        schemaChanged = true;
+        schema.erase(schema.begin() + statIdx, schema.end());
+    }
+
+    if (schemaChanged) {
+        writeSchema();
+        lastValues.assign(values.size(), 0.0);
+    }
+    writeRecord();
+
+    lastValues.swap(values);
+    stream->flush();
+    return "";
+}
+
+bool
+Binary::valid() const
+{
+    return stream != nullptr && stream->good();
+}
+
+void
+Binary::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push_back(name);
+    else
+        path.push_back(path.back() + "." + name);
+}
+
+void
+Binary::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+template <typename Labels>
+void
+Binary::append(const Info &info, StatKind kind, const double *data,
+               size_t size, Labels labels)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    // Unlike the text output, stats with a zero prerequisite are still
+    // dumped to keep the layout of the records stable.
+    if (schemaChanged || statIdx >= schema.size() ||
+        schema[statIdx].info != &info || schema[statIdx].kind != kind ||
+        schema[statIdx].labels.size() != size) {
+        schemaChanged = true;
+        schema.erase(schema.begin() + statIdx, schema.end());
+        schema.push_back(Column{ &info, kind,
+            path.empty() ? info.name : path.back() + "." + info.name,
+            labels() });
+        assert(schema.back().labels.size() == size);
+    }
+
+    statIdx++;
+    values.insert(values.end(), data, data + size);
+}
+
+std::string
+Binary::visit(const ScalarInfo &info)
+{
+    const double value = info.result();
+    append(info, ScalarKind, &value, 1, [] {
+        return std::vector<std::string>(1);
+    });
+    return "";
+}
+
+std::string
+Binary::visit(const VectorInfo &info)
+{
+    const VResult &vr = info.result();
+    append(info, VectorKind, vr.data(), vr.size(), [&] {
+        return elementLabels(info.subnames, vr.size());
+    });
+    return "";
+}
+
+std::string
+Binary::visit(const DistInfo &info)
+{
+    const DistData &data = info.data;
+    std::vector<double> flat = {
+        data.samples, data.sum, data.squares, data.min_val, data.max_val,
+        data.underflow, data.overflow,
+    };
+    flat.insert(flat.end(), data.cvec.begin(), data.cvec.end());
+
+    append(info, DistKind, flat.data(), flat.size(), [&] {
+        std::vector<std::string> labels = {
+            "samples", "sum", "squares", "min_value", "max_value",
+            "underflows", "overflows",
+        };
+        for (size_t i = 0; i < data.cvec.size(); ++i) {
+            const Counter low = data.min + i * data.bucket_size;
+            labels.push_back(data.bucket_size == 1 ?
+                std::to_string((int64_t)low) :
+                std::to_string((int64_t)low) + "-" +
+                std::to_string((int64_t)(low + data.bucket_size - 1)));
+        }
+        return labels;
+    });
+    return "";
+}
+
+std::string
+Binary::visit(const VectorDistInfo &info)
+{
+    warn_once("Binary stat files don't support vector distributions.\n");
+    return "";
+}
+
+std::string
+Binary::visit(const Vector2dInfo &info)
+{
+    append(info, Vector2dKind, info.cvec.data(), info.cvec.size(), [&] {
+        std::vector<std::string> x = elementLabels(info.subnames, info.x);
+        std::vector<std::string> y = elementLabels(info.y_subnames, info.y);
+        std::vector<std::string> labels;
+        for (const auto &i : x) {
+            for (const auto &j : y)
+                labels.push_back(i + "::" + j);
+        }
+        return labels;
+    });
+    return "";
+}
+
+std::string
+Binary::visit(const FormulaInfo &info)
+{
+    const VResult &vr = info.result();
+    append(info, FormulaKind, vr.data(), vr.size(), [&] {
+        return elementLabels(info.subnames, vr.size());
+    });
+    return "";
+}
+
+std::string
+Binary::visit(const SparseHistInfo &info)
+{
+    warn_once("Binary stat files don't support sparse histograms.\n");
+    return "";
+}
+
+void
+Binary::writeSchema()
+{
+    buffer.clear();
+    buffer.push_back(SchemaBlock);
+    putU32(schema.size());
+    for (const auto &column : schema) {
+        buffer.push_back(column.kind);
+        putString(column.name);
+        putU32(column.labels.size());
+        for (const auto &label : column.labels)
+            putString(label);
+    }
+    stream->write((const char *)buffer.data(), buffer.size());
+}
+
+void
+Binary::writeRecord()
+{
+    assert(values.size() == lastValues.size());
+
+    buffer.clear();
+    buffer.push_back(RecordBlock);
+    putU64(curTick());
+    putU32(values.size());
+
+    if (!delta) {
+        for (double value : values) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            putU64(bits);
+        }
+    } else {
+        // The low bit of each varint tells a zigzag encoded integer delta
+        // (0) from an escaped raw double that follows (1).
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double value = values[i];
+            const double last = lastValues[i];
+            if (isIntegral(value) && isIntegral(last)) {
+                const int64_t diff = (int64_t)value - (int64_t)last;
+                const uint64_t zigzag =
+                    ((uint64_t)diff << 1) ^ (uint64_t)(diff >> 63);
+                putVarint(zigzag << 1);
+            } else {
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                putVarint(1);
+                putU64(bits);
+            }
+        }
+    }
+
+    stream->write((const char *)buffer.data(), buffer.size());
+}
+
+void
+Binary::put(const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void
+Binary::putU32(uint32_t value)
+{
+    value = htole(value);
+    put(&value, sizeof(value));
+}
+
+void
+Binary::putU64(uint64_t value)
+{
+    value = htole(value);
+    put(&value, sizeof(value));
+}
+
+void
+Binary::putString(const std::string &str)
+{
+    putU32(str.size());
+    put(str.data(), str.size());
+}
+
+void
+Binary::putVarint(uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(value);
+}
+
+Output *
+initBinary(const std::string &filename, bool delta)
+{
+    return new Binary(filename, delta);
+}
+
+} // namespace Stats
@@ -0,0 +1,152 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+class Info;
+
+/**
+ * Columnar binary stats output.
+ *
+ * The file starts with a header followed by a sequence of blocks. A
+ * schema block describes every stat (name, kind and the labels of its
+ * columns) and is written before the first dump and again whenever the
+ * set of dumped stats changes. Every dump then only appends a record
+ * block holding the current tick and one value per column, so nothing
+ * is formatted at dump time.
+ *
+ * Records are either raw little-endian doubles or, in delta mode,
+ * zigzag varints of the difference to the previous record for integral
+ * values, which is what most counters are. Non-integral values are
+ * escaped and stored raw. See src/python/m5/stats/binary.py for a
+ * reader.
+ */
+class Binary : public Output
+{
+  public:
+    static const char magic[8];
+    static const uint32_t version = 1;
+
+    enum BlockType : uint8_t {
+        SchemaBlock = 'S',
+        RecordBlock = 'R',
+    };
+
+    enum StatKind : uint8_t {
+        ScalarKind = 0,
+        VectorKind,
+        DistKind,
+        Vector2dKind,
+        FormulaKind,
+    };
+
+    Binary(const std::string &file, bool delta);
+    ~Binary();
+
+    Binary() = delete;
+    Binary(const Binary &other) = delete;
+
+  public: // Output interface
+    std::string begin() override;
+    std::string end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    std::string visit(const ScalarInfo &info) override;
+    std::string visit(const VectorInfo &info) override;
+    std::string visit(const DistInfo &info) override;
+    std::string visit(const VectorDistInfo &info) override;
+    std::string visit(const Vector2dInfo &info) override;
+    std::string visit(const FormulaInfo &info) override;
+    std::string visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** A stat as laid out in the current schema. */
+    struct Column
+    {
+        const Info *info;
+        StatKind kind;
+        std::string name;
+        std::vector<std::string> labels;
+    };
+
+    /**
+     * Append the values of a stat to the current record. The stat is
+     * checked against the schema; labels are only evaluated if it
+     * doesn't match, which forces a new schema block.
+     */
+    template <typename Labels>
+    void append(const Info &info, StatKind kind, const double *data,
+                size_t size, Labels labels);
+
+    void writeSchema();
+    void writeRecord();
+
+    void put(const void *data, size_t size);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putString(const std::string &str);
+    void putVarint(uint64_t value);
+
+  protected:
+    OutputStream *file;
+    std::ostream *stream;
+    const bool delta;
+
+    /** Group path, the top is the full prefix of the current group. */
+    std::vector<std::string> path;
+
+    std::vector<Column> schema;
+    /** Number of stats of the schema visited in the current dump. */
+    size_t statIdx;
+    bool schemaChanged;
+
+    /** Values of the current and the previous record. */
+    std::vector<double> values;
+    std::vector<double> lastValues;
+
+    /** Scratch buffer used to encode a record before writing it. */
+    std::vector<uint8_t> buffer;
+};
+
+Output *initBinary(const std::string &filename, bool delta);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
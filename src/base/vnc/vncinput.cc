@@ -59,7 +59,7 @@ VncInput::VncInput(const Params *p)
       fb(&FrameBuffer::dummy),
       _videoWidth(fb->width()), _videoHeight(fb->height()),
       captureEnabled(p->frame_capture),
-      captureCurrentFrame(0), captureLastHash(0),
+      captureCurrentFrame(0), captureLastVersion(0),
       imgFormat(p->img_format)
 {
     if (captureEnabled) {
@@ -78,6 +78,9 @@ VncInput::setFrameBuffer(const FrameBuffer *rfb)
     if (!rfb)
         panic("Trying to VNC frame buffer to NULL!");
 
+    // Versions of different frame buffers can't be compared
+    if (rfb != fb)
+        captureLastVersion = 0;
     fb = rfb;
 
     // Create the Image Writer object in charge of dumping
@@ -116,11 +119,10 @@ VncInput::captureFrameBuffer()
 {
     assert(captureImage);
 
-    // skip identical frames
-    uint64_t new_hash = fb->getHash();
-    if (captureLastHash == new_hash)
+    // skip frames that haven't changed since the last capture
+    if (fb->version() == captureLastVersion)
         return;
-    captureLastHash = new_hash;
+    captureLastVersion = fb->version();
 
     // get the filename for the current frame
     char frameFilenameBuffer[64];
@@ -223,8 +223,8 @@ class VncInput : public SimObject
     /** Directory to store captured frames to */
     OutputDirectory *captureOutputDirectory;
 
-    /** Computed hash of the last captured frame */
-    uint64_t captureLastHash;
+    /** Frame buffer version of the last captured frame */
+    uint64_t captureLastVersion;
 
     /** Cached ImgWriter object for writing out frame buffers to file */
     std::unique_ptr<ImgWriter> captureImage;
@@ -121,7 +121,8 @@ VncServer::DataEvent::process(int revent)
 VncServer::VncServer(const Params *p)
     : VncInput(p), listenEvent(NULL), dataEvent(NULL), number(p->number),
       dataFd(-1), sendUpdate(false),
-      supportsRawEnc(false), supportsResizeEnc(false)
+      supportsRawEnc(false), supportsResizeEnc(false),
+      fullUpdate(true), updateVersion(0)
 {
     if (p->port)
         listen(p->port);
@@ -478,6 +479,7 @@ VncServer::sendServerInit()
     if (!write(&msg))
         return;
     curState = NormalPhase;
+    fullUpdate = true;
 }
 
 void
@@ -565,6 +567,11 @@ VncServer::requestFbUpdate()
     DPRINTF(VNC, " -- x = %d y = %d w = %d h = %d\n", fbr.x, fbr.y, fbr.width,
             fbr.height);
 
+    // The client doesn't have a copy of the frame buffer to apply
+    // incremental updates to.
+    if (!fbr.incremental)
+        fullUpdate = true;
+
     sendFrameBufferUpdate();
 }
 
@@ -638,44 +645,54 @@ VncServer::sendFrameBufferUpdate()
     // The client will request data constantly, unless we throttle it
     sendUpdate = false;
 
-    DPRINTF(VNC, "Sending framebuffer update\n");
+    assert(fb);
 
-    FrameBufferUpdate fbu;
-    FrameBufferRect fbr;
+    // Find the runs of lines that changed since the last update
+    std::vector<FrameBuffer::LineRun> runs;
+    if (!fullUpdate)
+        runs = fb->dirtyRuns(updateVersion);
+    else if (fb->height())
+        runs.emplace_back(0, fb->height());
+    fullUpdate = false;
+    updateVersion = fb->version();
+
+    if (runs.empty()) {
+        DPRINTF(VNC, "Frame buffer unchanged, NOT sending update\n");
+        return;
+    }
 
-    fbu.type = ServerFrameBufferUpdate;
-    fbu.num_rects = 1;
-    fbr.x = 0;
-    fbr.y = 0;
-    fbr.width = videoWidth();
-    fbr.height = videoHeight();
-    fbr.encoding = EncodingRaw;
+    DPRINTF(VNC, "Sending framebuffer update (%d rectangles)\n",
+            runs.size());
 
-    // fix up endian
-    fbu.num_rects = htobe(fbu.num_rects);
-    fbr.x = htobe(fbr.x);
-    fbr.y = htobe(fbr.y);
-    fbr.width = htobe(fbr.width);
-    fbr.height = htobe(fbr.height);
-    fbr.encoding = htobe(fbr.encoding);
+    FrameBufferUpdate fbu;
+    fbu.type = ServerFrameBufferUpdate;
+    fbu.num_rects = htobe<uint16_t>(runs.size());
 
-    // send headers to client
-    if (!write(&fbu) || !write(&fbr))
+    // send header to client
+    if (!write(&fbu))
         return;
 
-    assert(fb);
-
     std::vector<uint8_t> line_buffer(pixelConverter.length * fb->width());
-    for (int y = 0; y < fb->height(); ++y) {
-        // Convert and send a line at a time
-        uint8_t *raw_pixel(line_buffer.data());
-        for (unsigned x = 0; x < fb->width(); ++x) {
-            pixelConverter.fromPixel(raw_pixel, fb->pixel(x, y));
-            raw_pixel += pixelConverter.length;
-        }
-
-        if (!write(line_buffer.data(), line_buffer.size()))
+    for (const auto &run : runs) {
+        FrameBufferRect fbr;
+        fbr.x = 0;
+        fbr.y = htobe<uint16_t>(run.first);
+        fbr.width = htobe<uint16_t>(fb->width());
+        fbr.height = htobe<uint16_t>(run.second - run.first);
+        fbr.encoding = htobe<int32_t>(EncodingRaw);
+
+        if (!write(&fbr))
             return;
+
+        for (unsigned y = run.first; y < run.second; ++y) {
+            // Convert and send a line at a time
+            pixelConverter.fromPixels(line_buffer.data(),
+                                      fb->pixels.data() + y * fb->width(),
+                                      fb->width());
+
+            if (!write(line_buffer.data(), line_buffer.size()))
+                return;
+        }
     }
 }
 
@@ -712,6 +729,16 @@ VncServer::sendFrameBufferResized()
     // No actual data is sent in this message
 }
 
+void
+VncServer::setFrameBuffer(const FrameBuffer *rfb)
+{
+    // Changes are tracked per frame buffer
+    if (rfb != fb)
+        fullUpdate = true;
+
+    VncInput::setFrameBuffer(rfb);
+}
+
 void
 VncServer::setDirty()
 {
@@ -724,6 +751,8 @@ VncServer::setDirty()
 void
 VncServer::frameBufferResized()
 {
+    fullUpdate = true;
+
     if (dataFd > 0 && curState == NormalPhase) {
         if (supportsResizeEnc)
             sendFrameBufferResized();
@@ -202,6 +202,12 @@ class VncServer : public VncInput
     /** If the vnc client supports the desktop resize command */
     bool supportsResizeEnc;
 
+    /** The next update needs to cover the whole frame buffer */
+    bool fullUpdate;
+
+    /** Frame buffer version the client was last updated to */
+    uint64_t updateVersion;
+
   protected:
     /**
      * vnc client Interface
@@ -273,7 +279,9 @@ class VncServer : public VncInput
     void sendError(std::string error_msg);
 
     /** Send a updated frame buffer to the client.
-     * @todo this doesn't do anything smart and just sends the entire image
+     * Only the lines that changed since the last update are sent, as
+     * one rectangle per run of dirty lines, unless the client needs a
+     * full update.
      */
     void sendFrameBufferUpdate();
 
@@ -306,6 +314,7 @@ class VncServer : public VncInput
     static const PixelConverter pixelConverter;
 
   public:
+    void setFrameBuffer(const FrameBuffer *rfb) override;
     void setDirty() override;
     void frameBufferResized() override;
 };
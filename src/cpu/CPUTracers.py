@@ -35,6 +35,15 @@ class ExeTracer(InstTracer):
     cxx_class = 'Trace::ExeTracer'
     cxx_header = "cpu/exetrace.hh"
 
+class BinaryExeTracer(InstTracer):
+    type = 'BinaryExeTracer'
+    cxx_class = 'Trace::BinaryExeTracer'
+    cxx_header = "cpu/bin_exetrace.hh"
+    file_name = Param.String("", "Trace file, <name>.bin if empty; "
+        "compressed if it ends in .gz")
+    buffer_size = Param.MemorySize("4MB", "Size of each of the two "
+        "buffers handed to the writer thread")
+
 class IntelTrace(InstTracer):
     type = 'IntelTrace'
     cxx_class = 'Trace::IntelTrace'
@@ -36,3 +36,4 @@ class InstPBTrace(InstTracer):
     cxx_class = 'Trace::InstPBTrace'
     cxx_header = 'cpu/inst_pb_trace.hh'
     file_name = Param.String("Instruction trace output file")
+    trace_async = Param.Bool(True, "Write the trace on a background thread")
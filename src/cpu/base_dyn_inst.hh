@@ -196,6 +196,9 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Iterator pointing to this BaseDynInst in the list of all insts. */
     ListIt instListIt;
 
+    /** Instruction queue entry of this instruction, -1 if it has none. */
+    int16_t iqIdx;
+
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
     TheISA::PCState predPC;
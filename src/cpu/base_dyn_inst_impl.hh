@@ -105,6 +105,7 @@ BaseDynInst<Impl>::initVars()
     instFlags[Predicate] = true;
     instFlags[MemAccPredicate] = true;
 
+    iqIdx = -1;
     lqIdx = -1;
     sqIdx = -1;
 
@@ -0,0 +1,249 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/bin_exetrace.hh"
+
+#include <sstream>
+
+#include "arch/utility.hh"
+#include "base/callback.hh"
+#include "base/loader/symtab.hh"
+#include "base/logging.hh"
+#include "config/the_isa.hh"
+#include "cpu/base.hh"
+#include "cpu/op_class.hh"
+#include "cpu/thread_context.hh"
+#include "debug/ExecAll.hh"
+#include "debug/FmtFlag.hh"
+#include "debug/FmtTicksOff.hh"
+#include "enums/OpClass.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
+#include "sim/full_system.hh"
+
+namespace Trace {
+
+static_assert(sizeof(BinaryExeTracer::Record) == 72,
+              "Unexpected padding in binary trace records");
+
+void
+BinaryExeTracerRecord::traceInst(const StaticInstPtr &inst, bool ran)
+{
+    if (!Debug::ExecUser || !Debug::ExecKernel) {
+        bool in_user_mode = TheISA::inUserMode(thread);
+        if (in_user_mode && !Debug::ExecUser) return;
+        if (!in_user_mode && !Debug::ExecKernel) return;
+    }
+
+    typedef BinaryExeTracer T;
+
+    uint16_t format = 0;
+    if (Debug::ExecAsid) format |= T::FmtAsid;
+    if (Debug::ExecThread) format |= T::FmtThread;
+    if (Debug::ExecOpClass) format |= T::FmtOpClass;
+    if (Debug::ExecResult) format |= T::FmtResult;
+    if (Debug::ExecEffAddr) format |= T::FmtEffAddr;
+    if (Debug::ExecFetchSeq) format |= T::FmtFetchSeq;
+    if (Debug::ExecCPSeq) format |= T::FmtCPSeq;
+    if (Debug::ExecFlags) format |= T::FmtInstFlags;
+    if (Debug::FmtTicksOff) format |= T::FmtTicksOff;
+    if (Debug::FmtFlag) format |= T::FmtFlag;
+
+    uint8_t status = 0;
+    if (ran) status |= T::Ran;
+    if (predicate) status |= T::Predicate;
+    if (getMemValid()) status |= T::MemValid;
+    if (fetch_seq_valid) status |= T::FetchSeqValid;
+    if (cp_seq_valid) status |= T::CPSeqValid;
+    if (inst->isMicroop()) status |= T::Microop;
+    if (debugSymbolTable && Debug::ExecSymbol &&
+            (!FullSystem || !TheISA::inUserMode(thread))) {
+        status |= T::UseSymbol;
+    }
+
+    const bool vec_data =
+        data_status == DataVec || data_status == DataVecPred;
+
+    T::Record record;
+    record.type = T::RecordBlock;
+    record.status = status;
+    record.opClass = inst->opClass();
+    record.dataStatus = data_status;
+    record.cpu = htole(tracer.cpuId(thread->getCpuPtr()));
+    record.thread = htole((uint16_t)thread->threadId());
+    record.microPC = htole((uint16_t)pc.microPC());
+    record.format = htole(format);
+    record.inst = htole(tracer.instId(inst, pc.instAddr()));
+    record.tick = htole((uint64_t)when);
+    record.pc = htole((uint64_t)pc.instAddr());
+    record.asid = Debug::ExecAsid ?
+        htole((uint64_t)TheISA::getExecutingAsid(thread)) : 0;
+    record.data = vec_data ? 0 : htole(data.as_int);
+    record.addr = htole((uint64_t)addr);
+    record.fetchSeq = htole((uint64_t)fetch_seq);
+    record.cpSeq = htole((uint64_t)cp_seq);
+    tracer.write(&record, sizeof(record));
+
+    if (data_status == DataVec) {
+        auto dv = data.as_vec->as<uint32_t>();
+        for (int i = 0; i < TheISA::VecRegSizeBytes / 4; i++) {
+            const uint32_t word = htole(dv[i]);
+            tracer.write(&word, sizeof(word));
+        }
+    } else if (data_status == DataVecPred) {
+        auto pv = data.as_pred->as<uint8_t>();
+        for (int i = 0; i < TheISA::VecPredRegSizeBits; i++) {
+            const uint8_t bit = pv[i] ? 1 : 0;
+            tracer.write(&bit, sizeof(bit));
+        }
+    }
+}
+
+const char BinaryExeTracer::magic[8] =
+    { 'g', 'e', 'm', '5', 'e', 'x', 'e', 'c' };
+
+BinaryExeTracer::BinaryExeTracer(const Params *params)
+    : InstTracer(params)
+{
+    const std::string file_name = params->file_name.empty() ?
+        name() + ".bin" : params->file_name;
+    file = simout.create(file_name, true);
+    if (!file->stream()->good())
+        fatal("Unable to open instruction trace file '%s'\n", file_name);
+
+    std::ostream *stream = file->stream();
+    writer.reset(new AsyncWriter([stream](const char *data, size_t size) {
+        stream->write(data, size);
+    }, params->buffer_size));
+
+    write(magic, sizeof(magic));
+    for (uint32_t value : { version, (uint32_t)TheISA::VecRegSizeBytes,
+                            (uint32_t)TheISA::VecPredRegSizeBits,
+                            (uint32_t)Num_OpClasses }) {
+        value = htole(value);
+        write(&value, sizeof(value));
+    }
+    for (int i = 0; i < Num_OpClasses; i++)
+        writeString(Enums::OpClassStrings[i]);
+
+    registerExitCallback(
+        new MakeCallback<BinaryExeTracer, &BinaryExeTracer::close>(this));
+}
+
+BinaryExeTracer::~BinaryExeTracer()
+{
+    close();
+}
+
+InstRecord *
+BinaryExeTracer::getInstRecord(Tick when, ThreadContext *tc,
+                               const StaticInstPtr staticInst,
+                               TheISA::PCState pc,
+                               const StaticInstPtr macroStaticInst)
+{
+    if (!Debug::ExecEnable || !writer)
+        return NULL;
+
+    return new BinaryExeTracerRecord(*this, when, tc, staticInst, pc,
+                                     macroStaticInst);
+}
+
+uint16_t
+BinaryExeTracer::cpuId(BaseCPU *cpu)
+{
+    for (size_t i = 0; i < cpus.size(); i++) {
+        if (cpus[i] == cpu)
+            return i;
+    }
+
+    const uint16_t id = cpus.size();
+    cpus.push_back(cpu);
+
+    const uint8_t type = CpuBlock;
+    write(&type, sizeof(type));
+    writeString(cpu->name());
+    return id;
+}
+
+uint32_t
+BinaryExeTracer::instId(const StaticInstPtr &inst, Addr pc)
+{
+    auto it = instIds.find(std::make_pair(inst.get(), pc));
+    if (it != instIds.end())
+        return it->second;
+
+    const uint32_t id = insts.size();
+    insts.push_back(inst);
+    instIds.emplace(std::make_pair(inst.get(), pc), id);
+
+    std::string sym_str;
+    Addr sym_addr;
+    if (debugSymbolTable &&
+            debugSymbolTable->findNearestSymbol(pc, sym_str, sym_addr)) {
+        if (pc != sym_addr)
+            sym_str += csprintf("+%d", pc - sym_addr);
+        sym_str = "@" + sym_str;
+    } else {
+        sym_str.clear();
+    }
+
+    std::ostringstream flags;
+    inst->printFlags(flags, "|");
+
+    const uint8_t type = InstBlock;
+    write(&type, sizeof(type));
+    writeString(inst->disassemble(pc, debugSymbolTable));
+    writeString(sym_str);
+    writeString(flags.str());
+    return id;
+}
+
+void
+BinaryExeTracer::writeString(const std::string &str)
+{
+    const uint32_t size = htole((uint32_t)str.size());
+    write(&size, sizeof(size));
+    write(str.data(), str.size());
+}
+
+void
+BinaryExeTracer::close()
+{
+    if (!writer)
+        return;
+
+    writer.reset();
+    simout.close(file);
+    file = nullptr;
+}
+
+} // namespace Trace
+
+Trace::BinaryExeTracer *
+BinaryExeTracerParams::create()
+{
+    return new Trace::BinaryExeTracer(this);
+}
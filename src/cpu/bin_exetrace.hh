@@ -0,0 +1,197 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_BIN_EXETRACE_HH__
+#define __CPU_BIN_EXETRACE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/async_writer.hh"
+#include "base/output.hh"
+#include "cpu/exetrace.hh"
+#include "params/BinaryExeTracer.hh"
+
+class BaseCPU;
+
+namespace Trace {
+
+class BinaryExeTracer;
+
+class BinaryExeTracerRecord : public ExeTracerRecord
+{
+  public:
+    BinaryExeTracerRecord(BinaryExeTracer &_tracer, Tick _when,
+                          ThreadContext *_thread,
+                          const StaticInstPtr _staticInst,
+                          TheISA::PCState _pc,
+                          const StaticInstPtr _macroStaticInst = NULL)
+        : ExeTracerRecord(_when, _thread, _staticInst, _pc,
+                          _macroStaticInst),
+          tracer(_tracer)
+    {
+    }
+
+    void traceInst(const StaticInstPtr &inst, bool ran) override;
+
+  protected:
+    BinaryExeTracer &tracer;
+};
+
+/**
+ * Instruction tracer that writes the information printed by the
+ * ExeTracer as fixed-size binary records instead of text.
+ *
+ * Everything that is expensive to format is only produced once: the
+ * disassembly, symbol and flags of an instruction at a given PC are
+ * written to an instruction table the first time it is traced and
+ * records only refer to them. Records are collected in large buffers
+ * that are written, and compressed if the file name ends in .gz, by a
+ * background thread. The Exec* and Fmt* debug flags are sampled for
+ * every record, so util/decode_exetrace.py can reproduce the text trace
+ * the ExeTracer would have printed.
+ */
+class BinaryExeTracer : public InstTracer
+{
+  public:
+    typedef BinaryExeTracerParams Params;
+
+    static const char magic[8];
+    static const uint32_t version = 1;
+
+    enum BlockType : uint8_t {
+        CpuBlock = 'C',
+        InstBlock = 'D',
+        RecordBlock = 'I',
+    };
+
+    /** Debug flags affecting the format of a record. */
+    enum FormatFlags : uint16_t {
+        FmtAsid = 1 << 0,
+        FmtThread = 1 << 1,
+        FmtOpClass = 1 << 2,
+        FmtResult = 1 << 3,
+        FmtEffAddr = 1 << 4,
+        FmtFetchSeq = 1 << 5,
+        FmtCPSeq = 1 << 6,
+        FmtInstFlags = 1 << 7,
+        FmtTicksOff = 1 << 8,
+        FmtFlag = 1 << 9,
+    };
+
+    /** State of the traced instruction. */
+    enum StatusFlags : uint8_t {
+        Ran = 1 << 0,
+        Predicate = 1 << 1,
+        MemValid = 1 << 2,
+        FetchSeqValid = 1 << 3,
+        CPSeqValid = 1 << 4,
+        Microop = 1 << 5,
+        UseSymbol = 1 << 6,
+    };
+
+    /**
+     * Little-endian record of a traced instruction. Records of vector
+     * results are followed by the register contents.
+     */
+    struct Record
+    {
+        uint8_t type;
+        uint8_t status;
+        uint8_t opClass;
+        uint8_t dataStatus;
+        uint16_t cpu;
+        uint16_t thread;
+        uint16_t microPC;
+        uint16_t format;
+        uint32_t inst;
+        uint64_t tick;
+        uint64_t pc;
+        uint64_t asid;
+        uint64_t data;
+        uint64_t addr;
+        uint64_t fetchSeq;
+        uint64_t cpSeq;
+    };
+
+    BinaryExeTracer(const Params *params);
+    ~BinaryExeTracer();
+
+    InstRecord *getInstRecord(Tick when, ThreadContext *tc,
+                              const StaticInstPtr staticInst,
+                              TheISA::PCState pc,
+                              const StaticInstPtr macroStaticInst = NULL)
+        override;
+
+    /** Index of a CPU, its name is written the first time it is seen. */
+    uint16_t cpuId(BaseCPU *cpu);
+
+    /**
+     * Index of an instruction at a PC in the instruction table, its
+     * disassembly is written the first time it is seen.
+     */
+    uint32_t instId(const StaticInstPtr &inst, Addr pc);
+
+    void
+    write(const void *data, size_t size)
+    {
+        writer->write(data, size);
+    }
+
+    /** Write out all buffered records and close the file. */
+    void close();
+
+  protected:
+    struct InstKeyHash
+    {
+        size_t
+        operator()(const std::pair<const StaticInst *, Addr> &key) const
+        {
+            return std::hash<const StaticInst *>()(key.first) ^
+                std::hash<Addr>()(key.second) * 31;
+        }
+    };
+
+    void writeString(const std::string &str);
+
+    OutputStream *file;
+    std::unique_ptr<AsyncWriter> writer;
+
+    std::vector<BaseCPU *> cpus;
+
+    std::unordered_map<std::pair<const StaticInst *, Addr>, uint32_t,
+                       InstKeyHash> instIds;
+    /** References to all traced instructions to keep their keys unique. */
+    std::vector<StaticInstPtr> insts;
+};
+
+} // namespace Trace
+
+#endif // __CPU_BIN_EXETRACE_HH__
@@ -31,10 +31,15 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
-#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "arch/isa_traits.hh"
 #include "arch/types.hh"
+#include "base/types.hh"
 #include "config/the_isa.hh"
 #include "cpu/static_inst_fwd.hh"
 
@@ -46,9 +51,95 @@ namespace TheISA
 namespace DecodeCache
 {
 
-/// Hash for decoded instructions.
+/// Spread the bits of a hash over the upper bits of a 64 bit word. Keys
+/// like addresses and machine instructions often differ only in a few
+/// low or high bits, which clusters badly in power of two tables.
+inline uint64_t
+mixHash(uint64_t hash)
+{
+    return hash * ULL(0x9e3779b97f4a7c15);
+}
+
+/// Hash for decoded instructions, an open-addressed table with linear
+/// probing. Entries are never removed.
 template <typename EMI>
-using InstMap = std::unordered_map<EMI, StaticInstPtr>;
+class InstMap
+{
+  public:
+    typedef std::pair<EMI, StaticInstPtr> value_type;
+    typedef value_type *iterator;
+
+  protected:
+    std::vector<value_type> slots;
+    std::vector<bool> used;
+    /// Number of bits of the slot index.
+    unsigned indexBits;
+    size_t numEntries;
+
+    size_t
+    slotOf(const EMI &key) const
+    {
+        return mixHash(std::hash<EMI>()(key)) >> (64 - indexBits);
+    }
+
+    void
+    grow()
+    {
+        // Swap in an empty table of twice the size, then rehash.
+        std::vector<value_type> old_slots(slots.size() * 2);
+        std::vector<bool> old_used(old_slots.size(), false);
+        old_slots.swap(slots);
+        old_used.swap(used);
+        indexBits++;
+
+        for (size_t i = 0; i < old_slots.size(); i++) {
+            if (!old_used[i])
+                continue;
+            size_t slot = slotOf(old_slots[i].first);
+            while (used[slot])
+                slot = (slot + 1) & (slots.size() - 1);
+            used[slot] = true;
+            slots[slot] = std::move(old_slots[i]);
+        }
+    }
+
+  public:
+    InstMap() : slots(256), used(256, false), indexBits(8), numEntries(0)
+    {}
+
+    iterator end() { return nullptr; }
+
+    iterator
+    find(const EMI &key)
+    {
+        for (size_t slot = slotOf(key); used[slot];
+             slot = (slot + 1) & (slots.size() - 1)) {
+            if (slots[slot].first == key)
+                return &slots[slot];
+        }
+        return end();
+    }
+
+    StaticInstPtr &
+    operator[](const EMI &key)
+    {
+        iterator it = find(key);
+        if (it != end())
+            return it->second;
+
+        // Keep the table at most half full.
+        if (2 * (numEntries + 1) > slots.size())
+            grow();
+
+        size_t slot = slotOf(key);
+        while (used[slot])
+            slot = (slot + 1) & (slots.size() - 1);
+        used[slot] = true;
+        numEntries++;
+        slots[slot].first = key;
+        return slots[slot].second;
+    }
+};
 
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value>
@@ -59,63 +150,112 @@ class AddrMap
     struct CachePage {
         Value items[TheISA::PageBytes];
     };
-    // A map of cache pages which allows a sparse mapping.
-    typedef typename std::unordered_map<Addr, CachePage *> PageMap;
-    typedef typename PageMap::iterator PageIt;
-    // Mini cache of recent lookups.
-    PageIt recent[2];
-    PageMap pageMap;
-
-    /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
+
+    /// A page of the map and its address.
+    struct PageEntry {
+        Addr addr;
+        CachePage *page;
+    };
+
+    /// An address no page can have, page addresses are aligned.
+    static const Addr invalidAddr = 1;
+
+    /// Number of entries of the direct-mapped cache of recent pages.
+    static const unsigned numRecent = 64;
+
+    /// Direct-mapped cache of recently used pages, indexed by the page
+    /// number, in front of the page table.
+    PageEntry recent[numRecent];
+
+    /// Open-addressed table of all pages with linear probing. Empty
+    /// entries have no page.
+    std::vector<PageEntry> pageTable;
+    /// Number of bits of the page table index.
+    unsigned indexBits;
+    size_t numPages;
+
+    /// Owner of the pages.
+    std::vector<std::unique_ptr<CachePage>> pages;
+
+    size_t
+    slotOf(Addr page_addr) const
+    {
+        return mixHash(page_addr) >> (64 - indexBits);
+    }
+
     void
-    update(PageIt recentest)
+    insert(const PageEntry &entry)
     {
-        recent[1] = recent[0];
-        recent[0] = recentest;
+        size_t slot = slotOf(entry.addr);
+        while (pageTable[slot].page)
+            slot = (slot + 1) & (pageTable.size() - 1);
+        pageTable[slot] = entry;
+    }
+
+    void
+    grow()
+    {
+        // Swap in an empty table of twice the size, then rehash.
+        std::vector<PageEntry> old_table(pageTable.size() * 2,
+                                         PageEntry{ invalidAddr, nullptr });
+        old_table.swap(pageTable);
+        indexBits++;
+
+        for (const auto &entry : old_table) {
+            if (entry.page)
+                insert(entry);
+        }
+    }
+
+    /// Look for the page in the page table, adding a new page if it
+    /// isn't there.
+    /// @param page_addr The address of the page.
+    CachePage *
+    findPage(Addr page_addr)
+    {
+        for (size_t slot = slotOf(page_addr); pageTable[slot].page;
+             slot = (slot + 1) & (pageTable.size() - 1)) {
+            if (pageTable[slot].addr == page_addr)
+                return pageTable[slot].page;
+        }
+
+        // Didn't find an existing page, so add a new one. Keep the table
+        // at most half full.
+        if (2 * (numPages + 1) > pageTable.size())
+            grow();
+
+        pages.emplace_back(new CachePage);
+        insert(PageEntry{ page_addr, pages.back().get() });
+        numPages++;
+        return pages.back().get();
     }
 
     /// Attempt to find the CacheePage which goes with a particular
-    /// address. First check the small cache of recent results, then
-    /// actually look in the hash map.
+    /// address. First check the cache of recent pages, then actually
+    /// look in the page table.
     /// @param addr The address to look up.
     CachePage *
     getPage(Addr addr)
     {
         Addr page_addr = addr & ~(TheISA::PageBytes - 1);
 
-        // Check against recent lookups.
-        if (recent[0] != pageMap.end()) {
-            if (recent[0]->first == page_addr)
-                return recent[0]->second;
-            if (recent[1] != pageMap.end() &&
-                    recent[1]->first == page_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
+        PageEntry &entry =
+            recent[(page_addr / TheISA::PageBytes) % numRecent];
+        if (entry.addr != page_addr) {
+            entry.page = findPage(page_addr);
+            entry.addr = page_addr;
         }
-
-        // Actually look in the has_map.
-        PageIt it = pageMap.find(page_addr);
-        if (it != pageMap.end()) {
-            update(it);
-            return it->second;
-        }
-
-        // Didn't find an existing page, so add a new one.
-        CachePage *newPage = new CachePage;
-        page_addr = page_addr & ~(TheISA::PageBytes - 1);
-        typename PageMap::value_type to_insert(page_addr, newPage);
-        update(pageMap.insert(to_insert).first);
-        return newPage;
+        return entry.page;
     }
 
   public:
     /// Constructor
     AddrMap()
+        : pageTable(64, PageEntry{ invalidAddr, nullptr }), indexBits(6),
+          numPages(0)
     {
-        recent[0] = recent[1] = pageMap.end();
+        for (auto &entry : recent)
+            entry = PageEntry{ invalidAddr, nullptr };
     }
 
     Value &
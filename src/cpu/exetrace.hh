@@ -54,7 +54,7 @@ class ExeTracerRecord : public InstRecord
     {
     }
 
-    void traceInst(const StaticInstPtr &inst, bool ran);
+    virtual void traceInst(const StaticInstPtr &inst, bool ran);
 
     void dump();
 };
@@ -72,17 +72,17 @@ InstPBTrace::InstPBTrace(const InstPBTraceParams *p)
     : InstTracer(p), buf(nullptr), bufSize(0), curMsg(nullptr)
 {
     // Create our output file
-    createTraceFile(p->file_name);
+    createTraceFile(p->file_name, p->trace_async);
 }
 
 void
-InstPBTrace::createTraceFile(std::string filename)
+InstPBTrace::createTraceFile(std::string filename, bool async)
 {
     // Since there is only one output file for all tracers check if it exists
     if (traceStream)
         return;
 
-    traceStream = new ProtoOutputStream(simout.resolve(filename));
+    traceStream = new ProtoOutputStream(simout.resolve(filename), async);
 
     // Output the header
     ProtoMessage::InstHeader header_msg;
@@ -114,6 +114,14 @@ InstPBTrace::closeStreams()
     traceStream = NULL;
 }
 
+DrainState
+InstPBTrace::drain()
+{
+    if (traceStream)
+        traceStream->flush();
+    return DrainState::Drained;
+}
+
 InstPBTrace::~InstPBTrace()
 {
     closeStreams();
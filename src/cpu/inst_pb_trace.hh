@@ -92,6 +92,9 @@ class InstPBTrace : public InstTracer
                                     StaticInstPtr si, TheISA::PCState pc, const
                                     StaticInstPtr mi = NULL) override;
 
+    /** Write out the instructions buffered by the output stream. */
+    DrainState drain() override;
+
   protected:
     std::unique_ptr<uint8_t []> buf;
     size_t bufSize;
@@ -110,8 +113,9 @@ class InstPBTrace : public InstTracer
     /** Create the output file and write the header into it
      * @param filename the file to create (if ends with .gz it will be
      * compressed)
+     * @param async compress and write the file on a background thread
      */
-    void createTraceFile(std::string filename);
+    void createTraceFile(std::string filename, bool async);
 
     /** If there is a pending message still write it out and then close the file
      */
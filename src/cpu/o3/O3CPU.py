@@ -76,6 +76,9 @@ class DerivO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    skipIdleCycles = Param.Bool(False, "Stop ticking while no stage has "
+          "any activity and account the skipped cycles on wakeup or when "
+          "stats are dumped or reset")
 
     cacheStorePorts = Param.Unsigned(200, "Cache Ports. "
           "Constrains stores only.")
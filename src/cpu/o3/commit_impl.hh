@@ -1151,7 +1151,7 @@ DefaultCommit<Impl>::commitInsts()
     }
 
     DPRINTF(CommitRate, "%i\n", num_committed);
-    numCommittedDist.sample(num_committed);
+    cpu->cycleStats.sample(numCommittedDist, num_committed);
 
     if (num_committed == commitWidth) {
         commitEligibleSamples++;
@@ -144,6 +144,8 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
       activityRec(name(), NumStages,
                   params->backComSize + params->forwardComSize,
                   params->activity),
+      skipIdleCycles(params->skipIdleCycles),
+      skippingCycles(false),
 
       globalSeqNum(1),
       system(params->system),
@@ -552,6 +554,10 @@ FullO3CPU<Impl>::tick()
     DPRINTF(O3CPU, "\n\nFullO3CPU: Ticking main, FullO3CPU.\n");
     assert(!switchedOut());
     assert(drainState() != DrainState::Drained);
+    // In case the tick was scheduled without waking the CPU up.
+    endCycleSkip();
+
+    cycleStats.clear();
 
     ++numCycles;
     ++ppred_numCycles;
@@ -626,6 +632,12 @@ FullO3CPU<Impl>::tick()
             DPRINTF(O3CPU, "Idle!\n");
             lastRunningCycle = curCycle();
             timesIdled++;
+        } else if (!activityRec.active() && canSkipIdleCycles()) {
+            // Nothing is in flight, so every cycle until something wakes
+            // the CPU up would repeat this one.
+            DPRINTF(O3CPU, "No activity, skipping cycles until woken.\n");
+            lastRunningCycle = curCycle();
+            skippingCycles = true;
         } else {
             schedule(tickEvent, clockEdge(Cycles(1)));
             DPRINTF(O3CPU, "Scheduling next tick!\n");
@@ -754,6 +766,8 @@ FullO3CPU<Impl>::activateContext(ThreadID tid)
     if (drainState() == DrainState::Drained)
         return;
 
+    endCycleSkip();
+
     // If we are time 0 or if the last activation time is in the past,
     // schedule the next tick and wake up the fetch unit
     if (lastActivatedCycle == 0 || lastActivatedCycle < curTick()) {
@@ -789,6 +803,7 @@ FullO3CPU<Impl>::suspendContext(ThreadID tid)
 
     // If this was the last thread then unschedule the tick event.
     if (activeThreads.size() == 0) {
+        endCycleSkip();
         unscheduleTickEvent();
         lastRunningCycle = curCycle();
         _status = Idle;
@@ -1009,6 +1024,8 @@ FullO3CPU<Impl>::drain()
 
     DPRINTF(Drain, "Draining...\n");
 
+    endCycleSkip();
+
     // We only need to signal a drain to the commit stage as this
     // initiates squashing controls the draining. Once the commit
     // stage commits an instruction where it is safe to stop, it'll
@@ -1745,30 +1762,108 @@ template <class Impl>
 void
 FullO3CPU<Impl>::wakeCPU()
 {
-    if (activityRec.active() || tickEvent.scheduled()) {
+    if ((activityRec.active() && !skippingCycles) || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
     }
 
     DPRINTF(Activity, "Waking up CPU\n");
 
-    Cycles cycles(curCycle() - lastRunningCycle);
-    // @todo: This is an oddity that is only here to match the stats
-    if (cycles > 1) {
-        --cycles;
-        idleCycles += cycles;
-        numCycles += cycles;
+    if (skippingCycles) {
+        endCycleSkip();
+    } else {
+        Cycles cycles(curCycle() - lastRunningCycle);
+        // @todo: This is an oddity that is only here to match the stats
+        if (cycles > 1) {
+            --cycles;
+            idleCycles += cycles;
+            numCycles += cycles;
+        }
     }
 
     schedule(tickEvent, clockEdge());
 }
 
+template <class Impl>
+bool
+FullO3CPU<Impl>::canSkipIdleCycles() const
+{
+    return skipIdleCycles && !iew.instQueue.hasReadyInsts() &&
+        !(powerPred && ppred_stat && ppred_stat->get_begin());
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::endCycleSkip()
+{
+    if (!skippingCycles)
+        return;
+
+    skippingCycles = false;
+
+    // Same accounting as for idle cycles, the CPU is ticked again in the
+    // current cycle.
+    Cycles cycles(curCycle() - lastRunningCycle);
+    lastRunningCycle = curCycle();
+    if (cycles <= 1)
+        return;
+    --cycles;
+
+    DPRINTF(O3CPU, "Skipped %d cycles without activity.\n", cycles);
+
+    numCycles += cycles;
+    ppred_numCycles += cycles;
+    ppred_cycle_count += cycles;
+    global_total_cycles += cycles;
+    cycleStats.replay(cycles);
+
+    if (!FullSystem && activeThreads.size() > 1) {
+        for (size_t i = 0; i < cycles % activeThreads.size(); ++i)
+            updateThreadPriority();
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::flushCycleSkip()
+{
+    // The current cycle hasn't been ticked, it is accounted later
+    // together with the rest of the skipped cycles.
+    const Cycles cur_cycle(curCycle());
+    if (!skippingCycles || cur_cycle <= lastRunningCycle + 1)
+        return;
+
+    endCycleSkip();
+    skippingCycles = true;
+    lastRunningCycle = Cycles(cur_cycle - 1);
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::resetStats()
+{
+    flushCycleSkip();
+    BaseO3CPU::resetStats();
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::preDumpStats()
+{
+    flushCycleSkip();
+    BaseO3CPU::preDumpStats();
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::wakeup(ThreadID tid)
 {
-    if (this->thread[tid]->status() != ThreadContext::Suspended)
+    if (this->thread[tid]->status() != ThreadContext::Suspended) {
+        // Make sure an interrupt for a running thread is noticed.
+        if (skippingCycles)
+            this->wakeCPU();
         return;
+    }
 
     this->wakeCPU();
 
@@ -61,6 +61,7 @@
 #include "cpu/base.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
+#include "cpu/o3/cycle_stats.hh"
 #include "cpu/o3/scoreboard.hh"
 #include "cpu/o3/thread_state.hh"
 #include "cpu/power/ppred_unit.hh"
@@ -194,6 +195,12 @@ class FullO3CPU : public BaseO3CPU
     /** Registers statistics. */
     void regStats() override;
 
+    /** Account skipped cycles before the stats are reset. */
+    void resetStats() override;
+
+    /** Account skipped cycles before the stats are dumped. */
+    void preDumpStats() override;
+
     ProbePointArg<PacketPtr> *ppInstAccessComplete;
     ProbePointArg<std::pair<DynInstPtr, PacketPtr> > *ppDataAccessComplete;
 
@@ -676,6 +683,37 @@ class FullO3CPU : public BaseO3CPU
     /** Wakes the CPU, rescheduling the CPU if it's not already active. */
     void wakeCPU();
 
+    /** Per-cycle statistics of the stages, replayed for skipped cycles. */
+    CycleStats cycleStats;
+
+  private:
+    /**
+     * Whether the CPU may stop ticking when no stage has any activity.
+     * Power prediction needs every cycle to be ticked once it started.
+     */
+    bool canSkipIdleCycles() const;
+
+    /**
+     * Account the cycles that weren't ticked since the CPU stopped for
+     * lack of activity, if it did.
+     */
+    void endCycleSkip();
+
+    /**
+     * Account the cycles skipped so far without waking up the CPU, so
+     * that a stats dump or reset doesn't move them to the next
+     * interval.
+     */
+    void flushCycleSkip();
+
+    /** Stop ticking while there is no activity. */
+    const bool skipIdleCycles;
+
+    /** The CPU stopped ticking for lack of activity. */
+    bool skippingCycles;
+
+  public:
+
     virtual void wakeup(ThreadID tid) override;
 
     /** Gets a free thread id. Use if thread ids change across system. */
@@ -0,0 +1,87 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_O3_CYCLE_STATS_HH__
+#define __CPU_O3_CYCLE_STATS_HH__
+
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+
+/**
+ * Per-cycle statistics updated by the pipeline stages during one tick.
+ *
+ * Stages update the statistics they count once per cycle (idle, blocked
+ * and stall cycles, per-cycle distributions) through this class, which
+ * remembers the updates of the current tick. When the CPU stops ticking
+ * because nothing is in flight, every skipped cycle would have repeated
+ * the last tick, so its updates are replayed once per skipped cycle when
+ * the CPU wakes up.
+ */
+class CycleStats
+{
+  public:
+    /** Forget the updates of the previous tick. */
+    void
+    clear()
+    {
+        scalars.clear();
+        samples.clear();
+    }
+
+    /** Count a cycle in a per-cycle statistic. */
+    void
+    count(Stats::Scalar &stat)
+    {
+        ++stat;
+        scalars.push_back(&stat);
+    }
+
+    /** Sample the per-cycle value of a distribution. */
+    void
+    sample(Stats::Distribution &dist, Counter value)
+    {
+        dist.sample(value);
+        samples.emplace_back(&dist, value);
+    }
+
+    /** Repeat the updates of the last tick for a number of cycles. */
+    void
+    replay(Counter cycles) const
+    {
+        for (auto stat : scalars)
+            *stat += cycles;
+        for (const auto &s : samples)
+            s.first->sample(s.second, cycles);
+    }
+
+  private:
+    std::vector<Stats::Scalar *> scalars;
+    std::vector<std::pair<Stats::Distribution *, Counter>> samples;
+};
+
+#endif // __CPU_O3_CYCLE_STATS_HH__
@@ -409,7 +409,7 @@ DefaultDecode<Impl>::skidInsert(ThreadID tid)
     DynInstPtr inst = NULL;
 
     while (!insts[tid].empty()) {
-        inst = insts[tid].front();
+        inst = std::move(insts[tid].front());
 
         insts[tid].pop();
 
@@ -610,9 +610,9 @@ DefaultDecode<Impl>::decode(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (decodeStatus[tid] == Blocked) {
-        ++decodeBlockedCycles;
+        cpu->cycleStats.count(decodeBlockedCycles);
     } else if (decodeStatus[tid] == Squashing) {
-        ++decodeSquashCycles;
+        cpu->cycleStats.count(decodeSquashCycles);
     }
 
     // Decode should try to decode as many instructions as its bandwidth
@@ -656,16 +656,16 @@ DefaultDecode<Impl>::decodeInsts(ThreadID tid)
         DPRINTF(Decode, "[tid:%i] Nothing to do, breaking out"
                 " early.\n",tid);
         // Should I change the status to idle?
-        ++decodeIdleCycles;
+        cpu->cycleStats.count(decodeIdleCycles);
         // powerPred->setCPUStalled(true);
         // powerPred->setNumInstrsPending(0);
         return;
     } else if (decodeStatus[tid] == Unblocking) {
         DPRINTF(Decode, "[tid:%i] Unblocking, removing insts from skid "
                 "buffer.\n",tid);
-        ++decodeUnblockCycles;
+        cpu->cycleStats.count(decodeUnblockCycles);
     } else if (decodeStatus[tid] == Running) {
-        ++decodeRunCycles;
+        cpu->cycleStats.count(decodeRunCycles);
     }
     // powerPred->setCPUStalled(false);
 
@@ -49,6 +49,7 @@
 #include "arch/isa_traits.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/base_dyn_inst.hh"
 #include "cpu/inst_seq.hh"
@@ -88,6 +89,19 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /** Allocate instructions from a pool, see DynInstPool. */
+    static void *
+    operator new(size_t size)
+    {
+        return DynInstPool<BaseO3DynInst>::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        DynInstPool<BaseO3DynInst>::release(p, size);
+    }
+
     /** Executes the instruction.*/
     Fault execute();
 
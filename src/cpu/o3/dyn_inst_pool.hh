@@ -0,0 +1,127 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_O3_DYN_INST_POOL_HH__
+#define __CPU_O3_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Per-thread pool of storage for dynamic instructions.
+ *
+ * Dynamic instructions are created for every fetched micro-op and die on
+ * commit or squash, so their lifetime is short and the number in flight
+ * is bounded by the pipeline. The pool hands out blocks carved from
+ * contiguous slabs and recycles them through a free list, which keeps
+ * the host allocator off the per-instruction path and keeps live
+ * instructions close together in memory. Every user of the pool adds
+ * its share up front with grow(), and the pool grows by another slab if
+ * it runs dry.
+ *
+ * Instructions opt in by forwarding their class-specific operator
+ * new/delete here. Requests that don't match the size of T (e.g., for a
+ * derived class) fall back to the global allocator.
+ */
+template <class T>
+class DynInstPool
+{
+  public:
+    static void *
+    allocate(size_t size)
+    {
+        if (size != sizeof(T))
+            return ::operator new(size);
+
+        Pool &p = pool();
+        if (p.freeBlocks.empty())
+            p.grow(p.capacity ? p.capacity : minSlabSize);
+
+        void *block = p.freeBlocks.back();
+        p.freeBlocks.pop_back();
+        return block;
+    }
+
+    static void
+    release(void *block, size_t size)
+    {
+        if (size != sizeof(T))
+            ::operator delete(block);
+        else
+            pool().freeBlocks.push_back(block);
+    }
+
+    /**
+     * Add n blocks to the pool of the calling thread. Users sharing a
+     * thread, e.g., several CPUs on one event queue, each add their own
+     * share.
+     */
+    static void
+    grow(size_t n)
+    {
+        if (n)
+            pool().grow(n);
+    }
+
+  private:
+    /** Number of blocks allocated when an empty pool is first used. */
+    static const size_t minSlabSize = 256;
+
+    struct Block
+    {
+        alignas(T) char storage[sizeof(T)];
+    };
+
+    struct Pool
+    {
+        std::vector<void *> freeBlocks;
+        size_t capacity = 0;
+
+        void
+        grow(size_t n)
+        {
+            Block *slab = static_cast<Block *>(
+                ::operator new(n * sizeof(Block)));
+            freeBlocks.reserve(capacity + n);
+            // Hand out blocks in address order.
+            for (size_t i = n; i-- > 0; )
+                freeBlocks.push_back(&slab[i]);
+            capacity += n;
+        }
+    };
+
+    static Pool &
+    pool()
+    {
+        // Instructions may outlive thread-local destructors at exit, so
+        // the pool and its slabs are never freed.
+        static thread_local Pool *p = new Pool;
+        return *p;
+    }
+};
+
+#endif // __CPU_O3_DYN_INST_POOL_HH__
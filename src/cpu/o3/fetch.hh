@@ -526,6 +526,9 @@ class DefaultFetch
     /** Queue of fetched instructions. Per-thread to prevent HoL blocking. */
     std::deque<DynInstPtr> fetchQueue[Impl::MaxThreads];
 
+    /** Instruction pool blocks still to be added on the next tick. */
+    size_t poolBlocks;
+
     /** Whether or not the fetch buffer data is valid. */
     bool fetchBufferValid[Impl::MaxThreads];
 
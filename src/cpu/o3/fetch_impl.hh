@@ -63,6 +63,7 @@
 //#include "cpu/checker/cpu.hh"
 #include "cpu/exetrace.hh"
 #include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/fetch.hh"
 #include "cpu/o3/isa_specific.hh"
 #include "cpu/power/event_type.hh"
@@ -152,6 +153,16 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
         // which may not hold the entire cache line.
         fetchBuffer[tid] = new uint8_t[fetchBufferSize];
     }
+
+    // Size the instruction pool for everything this CPU can have in
+    // flight: the ROB, the fetch queues and the instructions travelling
+    // between fetch and rename. The blocks are added on the first tick,
+    // since the pool belongs to the thread simulating the CPU.
+    poolBlocks = params->numROBEntries +
+        numThreads * fetchQueueSize +
+        fetchWidth * (params->fetchToDecodeDelay +
+                      params->decodeToRenameDelay +
+                      params->renameToIEWDelay + 2);
 }
 
 template <class Impl>
@@ -963,6 +974,11 @@ DefaultFetch<Impl>::tick()
 
     wroteToTimeBuffer = false;
 
+    if (poolBlocks) {
+        DynInstPool<DynInst>::grow(poolBlocks);
+        poolBlocks = 0;
+    }
+
     for (ThreadID i = 0; i < numThreads; ++i) {
         issuePipelinedIfetch[i] = false;
     }
@@ -995,7 +1011,7 @@ DefaultFetch<Impl>::tick()
     }
 
     // Record number of instructions fetched this cycle for distribution.
-    fetchNisnDist.sample(numInst);
+    cpu->cycleStats.sample(fetchNisnDist, numInst);
 
     if (status_change) {
         // Change the fetch stage status if there was a status change.
@@ -1030,8 +1046,10 @@ DefaultFetch<Impl>::tick()
         if (!stalls[tid].power_pred &&
             !stalls[tid].decode &&
             !fetchQueue[tid].empty()) {
-            const auto& inst = fetchQueue[tid].front();
-            toDecode->insts[toDecode->size++] = inst;
+            // Move the reference into the time buffer, the queue entry is
+            // popped below.
+            const auto& inst = toDecode->insts[toDecode->size++] =
+                std::move(fetchQueue[tid].front());
             DPRINTF(Fetch, "[tid:%i] [sn:%llu] Sending instruction to decode "
                     "from fetch queue. Fetch queue size: %i.\n",
                     tid, inst->seqNum, fetchQueue[tid].size());
@@ -1284,27 +1302,27 @@ DefaultFetch<Impl>::fetch(bool &status_change)
             fetchCacheLine(fetchAddr, tid, thisPC.instAddr());
 
             if (fetchStatus[tid] == IcacheWaitResponse)
-                ++icacheStallCycles;
+                cpu->cycleStats.count(icacheStallCycles);
                 //powerPred->setCPUStalled(true);
             else if (fetchStatus[tid] == ItlbWait)
-                ++fetchTlbCycles;
+                cpu->cycleStats.count(fetchTlbCycles);
                 //powerPred->setCPUStalled(true);
             else
-                ++fetchMiscStallCycles;
+                cpu->cycleStats.count(fetchMiscStallCycles);
                 //powerPred->setCPUStalled(true);
             return;
         } else if ((checkInterrupt(thisPC.instAddr()) && !delayedCommit[tid])) {
             // Stall CPU if an interrupt is posted and we're not issuing
             // an delayed commit micro-op currently (delayed commit instructions
             // are not interruptable by interrupts, only faults)
-            ++fetchMiscStallCycles;
+            cpu->cycleStats.count(fetchMiscStallCycles);
             //powerPred->setCPUStalled(true);
             DPRINTF(Fetch, "[tid:%i] Fetch is stalled!\n", tid);
             return;
         }
     } else {
         if (fetchStatus[tid] == Idle) {
-            ++fetchIdleCycles;
+            cpu->cycleStats.count(fetchIdleCycles);
             //powerPred->setCPUStalled(false);
             DPRINTF(Fetch, "[tid:%i] Fetch is idle!\n", tid);
         }
@@ -1713,38 +1731,38 @@ DefaultFetch<Impl>::profileStall(ThreadID tid) {
     // @todo Per-thread stats
 
     if (stalls[tid].drain) {
-        ++fetchPendingDrainCycles;
+        cpu->cycleStats.count(fetchPendingDrainCycles);
         DPRINTF(Fetch, "Fetch is waiting for a drain!\n");
     } else if (stalls[tid].power_pred) {
-        ++fetchPowerPredictorStall;
+        cpu->cycleStats.count(fetchPowerPredictorStall);
         DPRINTF(Fetch, "Fetch is stalled by power predictor!\n");
     } else if (activeThreads->empty()) {
-        ++fetchNoActiveThreadStallCycles;
+        cpu->cycleStats.count(fetchNoActiveThreadStallCycles);
         DPRINTF(Fetch, "Fetch has no active thread!\n");
     } else if (fetchStatus[tid] == Blocked) {
-        ++fetchBlockedCycles;
+        cpu->cycleStats.count(fetchBlockedCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is blocked!\n", tid);
     } else if (fetchStatus[tid] == Squashing) {
-        ++fetchSquashCycles;
+        cpu->cycleStats.count(fetchSquashCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is squashing!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitResponse) {
-        ++icacheStallCycles;
+        cpu->cycleStats.count(icacheStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting cache response!\n",
                 tid);
     } else if (fetchStatus[tid] == ItlbWait) {
-        ++fetchTlbCycles;
+        cpu->cycleStats.count(fetchTlbCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting ITLB walk to "
                 "finish!\n", tid);
     } else if (fetchStatus[tid] == TrapPending) {
-        ++fetchPendingTrapStallCycles;
+        cpu->cycleStats.count(fetchPendingTrapStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending trap!\n",
                 tid);
     } else if (fetchStatus[tid] == QuiescePending) {
-        ++fetchPendingQuiesceStallCycles;
+        cpu->cycleStats.count(fetchPendingQuiesceStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending quiesce "
                 "instruction!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitRetry) {
-        ++fetchIcacheWaitRetryStallCycles;
+        cpu->cycleStats.count(fetchIcacheWaitRetryStallCycles);
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for an I-cache retry!\n",
                 tid);
     } else if (fetchStatus[tid] == NoGoodAddr) {
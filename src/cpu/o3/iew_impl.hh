@@ -689,7 +689,7 @@ DefaultIEW<Impl>::skidInsert(ThreadID tid)
     DynInstPtr inst = NULL;
 
     while (!insts[tid].empty()) {
-        inst = insts[tid].front();
+        inst = std::move(insts[tid].front());
 
         insts[tid].pop();
 
@@ -941,10 +941,10 @@ DefaultIEW<Impl>::dispatch(ThreadID tid)
     //     check if stall conditions have passed
 
     if (dispatchStatus[tid] == Blocked) {
-        ++iewBlockCycles;
+        cpu->cycleStats.count(iewBlockCycles);
 
     } else if (dispatchStatus[tid] == Squashing) {
-        ++iewSquashCycles;
+        cpu->cycleStats.count(iewSquashCycles);
     }
 
     // Dispatch should try to dispatch as many instructions as its bandwidth
@@ -965,7 +965,7 @@ DefaultIEW<Impl>::dispatch(ThreadID tid)
         // the rest of unblocking.
         dispatchInsts(tid);
 
-        ++iewUnblockCycles;
+        cpu->cycleStats.count(iewUnblockCycles);
 
         if (validInstsFromRename()) {
             // Add the current inputs to the skid buffer so they can be
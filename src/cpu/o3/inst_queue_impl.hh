@@ -45,6 +45,7 @@
 #ifndef __CPU_O3_INST_QUEUE_IMPL_HH__
 #define __CPU_O3_INST_QUEUE_IMPL_HH__
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -93,12 +94,16 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
       powerPred(nullptr),
       iewStage(iew_ptr),
       fuPool(params->fuPool),
+      selectMatrix(params->numIQEntries, Num_OpClasses),
+      entryInsts(params->numIQEntries),
       iqPolicy(params->smtIQPolicy),
       numEntries(params->numIQEntries),
       totalWidth(params->issueWidth),
       commitToIEWDelay(params->commitToIEWDelay)
 {
     assert(fuPool);
+    fatal_if(numEntries > std::numeric_limits<int16_t>::max(),
+             "numIQEntries (%d) is too large.\n", numEntries);
 
     numThreads = params->numThreads;
 
@@ -423,14 +428,9 @@ InstructionQueue<Impl>::resetState()
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
-    }
+    selectMatrix.clear();
+    std::fill(entryInsts.begin(), entryInsts.end(), nullptr);
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -568,19 +568,9 @@ InstructionQueue<Impl>::isFull(ThreadID tid)
 
 template <class Impl>
 bool
-InstructionQueue<Impl>::hasReadyInsts()
+InstructionQueue<Impl>::hasReadyInsts() const
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return selectMatrix.anyReady();
 }
 
 template <class Impl>
@@ -607,6 +597,7 @@ InstructionQueue<Impl>::insert(const DynInstPtr &new_inst)
     --freeEntries;
 
     new_inst->setInIQ();
+    allocateEntry(new_inst);
 
     // Look through its source registers (physical regs), and mark any
     // dependencies.
@@ -658,6 +649,7 @@ InstructionQueue<Impl>::insertNonSpec(const DynInstPtr &new_inst)
     --freeEntries;
 
     new_inst->setInIQ();
+    allocateEntry(new_inst);
 
     // Have this instruction set itself as the producer of its destination
     // register(s).
@@ -704,55 +696,22 @@ InstructionQueue<Impl>::getInstToExecute()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+InstructionQueue<Impl>::allocateEntry(const DynInstPtr &inst)
 {
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
-    }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
+    assert(inst->iqIdx < 0);
+    inst->iqIdx = selectMatrix.allocate(inst->seqNum);
+    entryInsts[inst->iqIdx] = inst;
 }
 
 template <class Impl>
 void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+InstructionQueue<Impl>::releaseEntry(const DynInstPtr &inst)
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    const int entry = inst->iqIdx;
+    assert(entry >= 0);
+    inst->iqIdx = -1;
+    selectMatrix.release(entry);
+    entryInsts[entry] = nullptr;
 }
 
 template <class Impl>
@@ -798,24 +757,18 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
-    // FUs that handle it.
+    // Select ready instructions oldest first until the issue bandwidth
+    // is used up. If an instruction can't get a FU, none of the younger
+    // instructions of its op class are considered this cycle.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
-
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    int entry;
 
-        assert(!readyInsts[op_class].empty());
+    selectMatrix.beginSelect();
 
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+    while (total_issued < totalWidth &&
+           (entry = selectMatrix.selectOldest()) != SelectMatrix::NoEntry) {
+        DynInstPtr issuing_inst = entryInsts[entry];
+        OpClass op_class = issuing_inst->opClass();
 
         if (issuing_inst->isFloating()) {
             fpInstQueueReads++;
@@ -825,19 +778,8 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            selectMatrix.clearReady(entry);
 
             ++iqSquashedInstsIssued;
 
@@ -898,14 +840,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            selectMatrix.clearReady(entry);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -920,20 +855,20 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 ++freeEntries;
                 count[tid]--;
                 issuing_inst->clearInIQ();
+                releaseEntry(issuing_inst);
             } else {
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            selectMatrix.excludeClass(op_class);
         }
     }
 
-    numIssuedDist.sample(total_issued);
+    cpu->cycleStats.sample(numIssuedDist, total_issued);
     iqInstsIssued+= total_issued;
 
     // If we issued any instructions, tell the CPU we had activity.
@@ -1094,18 +1029,16 @@ InstructionQueue<Impl>::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
+    // Deferred or blocked instructions may have been squashed out of the
+    // IQ in the meantime.
+    if (ready_inst->iqIdx < 0) {
+        assert(ready_inst->isSquashed());
+        ++iqSquashedInstsIssued;
+        return;
     }
 
+    selectMatrix.setReady(ready_inst->iqIdx, op_class);
+
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
             ready_inst->pcState(), op_class, ready_inst->seqNum);
@@ -1142,6 +1075,7 @@ InstructionQueue<Impl>::completeMemInst(const DynInstPtr &completed_inst)
             completed_inst->pcState(), completed_inst->seqNum);
 
     ++freeEntries;
+    releaseEntry(completed_inst);
 
     completed_inst->memOpDone(true);
 
@@ -1342,6 +1276,12 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             squashed_inst->setCanCommit();
             squashed_inst->clearInIQ();
 
+            // Squashed instructions that were ready used to be dropped
+            // when select found them, count them here instead.
+            if (selectMatrix.isReady(squashed_inst->iqIdx))
+                ++iqSquashedInstsIssued;
+            releaseEntry(squashed_inst);
+
             //Update Thread IQ Count
             count[squashed_inst->threadNumber]--;
 
@@ -1482,17 +1422,7 @@ InstructionQueue<Impl>::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        selectMatrix.setReady(inst->iqIdx, op_class);
     }
 }
 
@@ -1508,7 +1438,7 @@ void
 InstructionQueue<Impl>::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        cprintf("Ready list %i size: %i\n", i, selectMatrix.numReady(i));
 
         cprintf("\n");
     }
@@ -1528,18 +1458,13 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
+    cprintf("Ready entries: ");
 
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
+    for (unsigned i = 0; i < numEntries; ++i) {
+        if (selectMatrix.isReady(i)) {
+            cprintf("%i OpClass:%i [sn:%llu] ", i, entryInsts[i]->opClass(),
+                    entryInsts[i]->seqNum);
+        }
     }
 
     cprintf("\n");
@@ -1641,7 +1566,7 @@ int
 InstructionQueue<Impl>::getNumReadyIntInstr() {
   size_t instrs = 0;
   for (int i = (int)IntAluOp; i <= (int)IntDivOp; i++) {
-    instrs += readyInsts[i].size();
+    instrs += selectMatrix.numReady(i);
   }
   return instrs;
 }
@@ -1656,7 +1581,7 @@ int
 InstructionQueue<Impl>::getNumReadyFloatInstr() {
   size_t instrs = 0;
   for (int i = (int)FloatAddOp; i <= (int)FloatSqrtOp; i++) {
-    instrs += readyInsts[i].size();
+    instrs += selectMatrix.numReady(i);
   }
   return instrs;
 }
@@ -1671,7 +1596,7 @@ int
 InstructionQueue<Impl>::getNumReadyMemInstr() {
   size_t instrs = 0;
   for (int i = (int)MemReadOp; i <= (int)FloatMemWriteOp; i++) {
-    instrs += readyInsts[i].size();
+    instrs += selectMatrix.numReady(i);
   }
   return instrs;
 }
@@ -1686,7 +1611,7 @@ int
 InstructionQueue<Impl>::getNumReadySIMDInstr() {
   size_t instrs = 0;
   for (int i = (int)SimdAddOp; i <= (int)SimdPredAluOp; i++) {
-    instrs += readyInsts[i].size();
+    instrs += selectMatrix.numReady(i);
   }
   return instrs;
 }
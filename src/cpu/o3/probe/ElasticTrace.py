@@ -59,6 +59,9 @@ class ElasticTrace(ProbeListenerObject):
                                     "after which to start tracing. Default " \
                                     "zero means start tracing from first " \
                                     "committed instruction.")
+    # Whether to compress and write the traces on a background thread
+    traceAsync = Param.Bool(True, "Set to true to write the traces on a " \
+                            "background thread.")
     # Whether to trace virtual addresses for memory accesses
     traceVirtAddr = Param.Bool(False, "Set to true if virtual addresses are " \
                                 "to be traced.")
@@ -76,9 +76,9 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams* params)
                 "trace file path to dataDepTraceFile");
     std::string filename = simout.resolve(name() + "." +
                                             params->instFetchTraceFile);
-    instTraceStream = new ProtoOutputStream(filename);
+    instTraceStream = new ProtoOutputStream(filename, params->traceAsync);
     filename = simout.resolve(name() + "." + params->dataDepTraceFile);
-    dataTraceStream = new ProtoOutputStream(filename);
+    dataTraceStream = new ProtoOutputStream(filename, params->traceAsync);
     // Create a protobuf message for the header and write it to the stream
     ProtoMessage::PacketHeader inst_pkt_header;
     inst_pkt_header.set_obj_id(name());
@@ -958,6 +958,19 @@ ElasticTrace::flushTraces()
     // Delete the stream objects
     delete dataTraceStream;
     delete instTraceStream;
+    dataTraceStream = NULL;
+    instTraceStream = NULL;
+}
+
+DrainState
+ElasticTrace::drain()
+{
+    // Records still in the dependency window are written at exit
+    if (dataTraceStream != NULL) {
+        dataTraceStream->flush();
+        instTraceStream->flush();
+    }
+    return DrainState::Drained;
 }
 
 ElasticTrace*
@@ -118,6 +118,9 @@ class ElasticTrace : public ProbeListenerObject
      */
     void flushTraces();
 
+    /** Write out the trace records buffered by the output streams. */
+    DrainState drain() override;
+
     /**
      * Take the fields of the request class object that are relevant to create
      * an instruction fetch request. It creates a protobuf message containing
@@ -500,11 +500,11 @@ DefaultRename<Impl>::rename(bool &status_change, ThreadID tid)
     //     check if stall conditions have passed
 
     if (renameStatus[tid] == Blocked) {
-        ++renameBlockCycles;
+        cpu->cycleStats.count(renameBlockCycles);
     } else if (renameStatus[tid] == Squashing) {
-        ++renameSquashCycles;
+        cpu->cycleStats.count(renameSquashCycles);
     } else if (renameStatus[tid] == SerializeStall) {
-        ++renameSerializeStallCycles;
+        cpu->cycleStats.count(renameSerializeStallCycles);
         // If we are currently in SerializeStall and resumeSerialize
         // was set, then that means that we are resuming serializing
         // this cycle.  Tell the previous stages to block.
@@ -559,12 +559,12 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
         DPRINTF(Rename, "[tid:%i] Nothing to do, breaking out early.\n",
                 tid);
         // Should I change status to idle?
-        ++renameIdleCycles;
+        cpu->cycleStats.count(renameIdleCycles);
         return;
     } else if (renameStatus[tid] == Unblocking) {
-        ++renameUnblockCycles;
+        cpu->cycleStats.count(renameUnblockCycles);
     } else if (renameStatus[tid] == Running) {
-        ++renameRunCycles;
+        cpu->cycleStats.count(renameRunCycles);
     }
 
     // Will have to do a different calculation for the number of free
@@ -805,7 +805,7 @@ DefaultRename<Impl>::skidInsert(ThreadID tid)
     DynInstPtr inst = NULL;
 
     while (!insts[tid].empty()) {
-        inst = insts[tid].front();
+        inst = std::move(insts[tid].front());
 
         insts[tid].pop_front();
 
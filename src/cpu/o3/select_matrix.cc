@@ -0,0 +1,179 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/o3/select_matrix.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/bitfield.hh"
+
+const int SelectMatrix::NoEntry;
+
+SelectMatrix::SelectMatrix(unsigned num_entries, unsigned num_classes)
+    : numEntries(num_entries), numClasses(num_classes),
+      numWords((num_entries + WordBits - 1) / WordBits),
+      valid(numWords), seqNums(num_entries),
+      ready(num_classes * numWords), readyAny(numWords),
+      readyClass(num_entries),
+      age(num_entries * numWords), candidates(numWords)
+{
+    clear();
+}
+
+void
+SelectMatrix::clear()
+{
+    std::fill(valid.begin(), valid.end(), 0);
+    std::fill(ready.begin(), ready.end(), 0);
+    std::fill(readyAny.begin(), readyAny.end(), 0);
+    std::fill(readyClass.begin(), readyClass.end(), -1);
+    std::fill(candidates.begin(), candidates.end(), 0);
+    numReadyEntries = 0;
+
+    // Hand out low entries first.
+    freeList.clear();
+    for (int entry = numEntries - 1; entry >= 0; --entry)
+        freeList.push_back(entry);
+}
+
+int
+SelectMatrix::allocate(InstSeqNum seq_num)
+{
+    assert(!freeList.empty());
+    const int entry = freeList.back();
+    freeList.pop_back();
+
+    const unsigned word = entry / WordBits;
+    Word *row = ageRow(entry);
+    std::fill(row, row + numWords, 0);
+
+    // Instructions don't necessarily enter the IQ in program order with
+    // several threads, so compare against every valid entry.
+    for (unsigned w = 0; w < numWords; ++w) {
+        Word others = valid[w];
+        while (others) {
+            const int other = w * WordBits + ctz64(others);
+            others &= others - 1;
+
+            if (seqNums[other] < seq_num) {
+                row[w] |= bit(other);
+                ageRow(other)[word] &= ~bit(entry);
+            } else {
+                ageRow(other)[word] |= bit(entry);
+            }
+        }
+    }
+
+    seqNums[entry] = seq_num;
+    valid[word] |= bit(entry);
+    return entry;
+}
+
+void
+SelectMatrix::release(int entry)
+{
+    assert(valid[entry / WordBits] & bit(entry));
+    clearReady(entry);
+    valid[entry / WordBits] &= ~bit(entry);
+    freeList.push_back(entry);
+}
+
+void
+SelectMatrix::setReady(int entry, unsigned op_class)
+{
+    assert(valid[entry / WordBits] & bit(entry));
+    assert(op_class < numClasses);
+
+    if (readyClass[entry] >= 0) {
+        assert(readyClass[entry] == (int)op_class);
+        return;
+    }
+
+    readyClass[entry] = op_class;
+    readyVector(op_class)[entry / WordBits] |= bit(entry);
+    readyAny[entry / WordBits] |= bit(entry);
+    ++numReadyEntries;
+}
+
+void
+SelectMatrix::clearReady(int entry)
+{
+    if (readyClass[entry] < 0)
+        return;
+
+    const unsigned word = entry / WordBits;
+    readyVector(readyClass[entry])[word] &= ~bit(entry);
+    readyAny[word] &= ~bit(entry);
+    candidates[word] &= ~bit(entry);
+    readyClass[entry] = -1;
+    --numReadyEntries;
+}
+
+unsigned
+SelectMatrix::numReady(unsigned op_class) const
+{
+    const Word *vec = readyVector(op_class);
+    unsigned num = 0;
+    for (unsigned w = 0; w < numWords; ++w)
+        num += popCount(vec[w]);
+    return num;
+}
+
+void
+SelectMatrix::beginSelect()
+{
+    candidates = readyAny;
+}
+
+int
+SelectMatrix::selectOldest() const
+{
+    for (unsigned w = 0; w < numWords; ++w) {
+        Word cands = candidates[w];
+        while (cands) {
+            const int entry = w * WordBits + ctz64(cands);
+            cands &= cands - 1;
+
+            // The oldest candidate is the one without older candidates.
+            const Word *row = ageRow(entry);
+            bool oldest = true;
+            for (unsigned v = 0; v < numWords && oldest; ++v)
+                oldest = !(row[v] & candidates[v]);
+            if (oldest)
+                return entry;
+        }
+    }
+    return NoEntry;
+}
+
+void
+SelectMatrix::excludeClass(unsigned op_class)
+{
+    const Word *vec = readyVector(op_class);
+    for (unsigned w = 0; w < numWords; ++w)
+        candidates[w] &= ~vec[w];
+}
@@ -0,0 +1,136 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_O3_SELECT_MATRIX_HH__
+#define __CPU_O3_SELECT_MATRIX_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/inst_seq.hh"
+
+/**
+ * Ready and age state of the instruction queue entries, kept as bit
+ * vectors so that the oldest ready instruction can be selected with a
+ * few word operations.
+ *
+ * Every instruction in the IQ holds an entry. Per op class, a ready
+ * vector has a bit set for each entry that can issue. The age matrix
+ * has one row per entry, with a bit set for every entry holding an
+ * older instruction, so an entry is the oldest of a set if its row
+ * doesn't intersect the set.
+ *
+ * Select works on a candidate set taken from the ready entries at the
+ * start of a cycle. Op classes that can't get a functional unit are
+ * removed from the candidates as a whole, which gives the same issue
+ * order as walking the ready instructions oldest first while skipping
+ * op classes that are busy.
+ */
+class SelectMatrix
+{
+  public:
+    /** Value returned when no entry could be found. */
+    static const int NoEntry = -1;
+
+    /**
+     * @param num_entries Number of IQ entries.
+     * @param num_classes Number of op classes.
+     */
+    SelectMatrix(unsigned num_entries, unsigned num_classes);
+
+    /** Release all entries. */
+    void clear();
+
+    /** Allocate an entry for the instruction with the given number. */
+    int allocate(InstSeqNum seq_num);
+
+    /** Release an entry, clearing its ready bit if it is set. */
+    void release(int entry);
+
+    /** Mark an entry as ready to issue to a unit of the given class. */
+    void setReady(int entry, unsigned op_class);
+
+    /** Clear the ready bit of an entry, e.g., after it has issued. */
+    void clearReady(int entry);
+
+    bool isReady(int entry) const { return readyClass[entry] >= 0; }
+
+    bool anyReady() const { return numReadyEntries != 0; }
+
+    /** Number of ready entries of an op class. */
+    unsigned numReady(unsigned op_class) const;
+
+    /** Take all ready entries as the candidates for select. */
+    void beginSelect();
+
+    /** Oldest candidate or NoEntry if there are no candidates left. */
+    int selectOldest() const;
+
+    /** Remove all ready entries of an op class from the candidates. */
+    void excludeClass(unsigned op_class);
+
+  private:
+    typedef uint64_t Word;
+    static const unsigned WordBits = 64;
+
+    static Word bit(int entry) { return Word(1) << (entry % WordBits); }
+
+    Word *readyVector(unsigned op_class)
+    { return &ready[op_class * numWords]; }
+    const Word *readyVector(unsigned op_class) const
+    { return &ready[op_class * numWords]; }
+
+    Word *ageRow(int entry) { return &age[entry * numWords]; }
+    const Word *ageRow(int entry) const { return &age[entry * numWords]; }
+
+    const unsigned numEntries;
+    const unsigned numClasses;
+    /** Number of words in a vector covering all entries. */
+    const unsigned numWords;
+
+    /** Entries holding an instruction. */
+    std::vector<Word> valid;
+    /** Sequence number of the instruction in each entry. */
+    std::vector<InstSeqNum> seqNums;
+    /** Free entries, used as a stack. */
+    std::vector<int> freeList;
+
+    /** Ready vectors, numWords per op class. */
+    std::vector<Word> ready;
+    /** Entries ready for any op class. */
+    std::vector<Word> readyAny;
+    /** Op class an entry is ready for, -1 if it isn't ready. */
+    std::vector<int> readyClass;
+    unsigned numReadyEntries;
+
+    /** Age matrix, one row of numWords per entry. */
+    std::vector<Word> age;
+
+    /** Remaining candidates of the current select. */
+    std::vector<Word> candidates;
+};
+
+#endif // __CPU_O3_SELECT_MATRIX_HH__
@@ -0,0 +1,385 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "cpu/o3/select_matrix.hh"
+
+namespace {
+
+struct Inst
+{
+    InstSeqNum seqNum;
+    unsigned opClass;
+    int entry;
+    bool ready;
+    bool squashed;
+};
+
+typedef std::shared_ptr<Inst> InstPtr;
+
+/**
+ * The ready lists the instruction queue used before SelectMatrix: a
+ * priority queue of ready instructions per op class, and a list of op
+ * classes ordered by the oldest ready instruction in each queue.
+ * Squashed instructions stay on the queues until select reaches them.
+ */
+class ReadyLists
+{
+  public:
+    explicit ReadyLists(unsigned num_classes)
+        : readyInsts(num_classes), queueOnList(num_classes, false),
+          readyIt(num_classes, listOrder.end())
+    {
+    }
+
+    void
+    addReady(const InstPtr &inst)
+    {
+        const unsigned op_class = inst->opClass;
+        readyInsts[op_class].push(inst);
+
+        if (!queueOnList[op_class]) {
+            addToOrderList(op_class);
+        } else if (readyInsts[op_class].top()->seqNum <
+                   readyIt[op_class]->oldestInst) {
+            listOrder.erase(readyIt[op_class]);
+            addToOrderList(op_class);
+        }
+    }
+
+    /**
+     * Issue up to width instructions, oldest first. fu_free is asked
+     * for a unit for every instruction that isn't squashed.
+     */
+    std::vector<InstPtr>
+    select(int width, const std::function<bool(unsigned)> &fu_free)
+    {
+        std::vector<InstPtr> issued;
+        auto order_it = listOrder.begin();
+
+        while ((int)issued.size() < width && order_it != listOrder.end()) {
+            const unsigned op_class = order_it->queueType;
+            InstPtr inst = readyInsts[op_class].top();
+
+            if (inst->squashed || fu_free(op_class)) {
+                readyInsts[op_class].pop();
+                if (!readyInsts[op_class].empty()) {
+                    moveToYoungerInst(order_it);
+                } else {
+                    readyIt[op_class] = listOrder.end();
+                    queueOnList[op_class] = false;
+                }
+                listOrder.erase(order_it++);
+
+                if (!inst->squashed)
+                    issued.push_back(inst);
+            } else {
+                ++order_it;
+            }
+        }
+        return issued;
+    }
+
+    /** Ready instructions of an op class, including squashed ones. */
+    unsigned numReady(unsigned op_class) const
+    { return readyInsts[op_class].size(); }
+
+    bool anyReady() const { return !listOrder.empty(); }
+
+  private:
+    struct ListOrderEntry
+    {
+        unsigned queueType;
+        InstSeqNum oldestInst;
+    };
+
+    typedef std::list<ListOrderEntry>::iterator ListOrderIt;
+
+    struct OlderFirst
+    {
+        bool
+        operator()(const InstPtr &a, const InstPtr &b) const
+        {
+            return a->seqNum > b->seqNum;
+        }
+    };
+
+    void
+    addToOrderList(unsigned op_class)
+    {
+        ListOrderEntry queue_entry{op_class,
+                                   readyInsts[op_class].top()->seqNum};
+        auto list_it = listOrder.begin();
+        while (list_it != listOrder.end() &&
+               list_it->oldestInst <= queue_entry.oldestInst) {
+            ++list_it;
+        }
+        readyIt[op_class] = listOrder.insert(list_it, queue_entry);
+        queueOnList[op_class] = true;
+    }
+
+    void
+    moveToYoungerInst(ListOrderIt list_order_it)
+    {
+        const unsigned op_class = list_order_it->queueType;
+        ListOrderEntry queue_entry{op_class,
+                                   readyInsts[op_class].top()->seqNum};
+        auto next_it = std::next(list_order_it);
+        while (next_it != listOrder.end() &&
+               next_it->oldestInst < queue_entry.oldestInst) {
+            ++next_it;
+        }
+        readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    }
+
+    std::vector<std::priority_queue<InstPtr, std::vector<InstPtr>,
+                                    OlderFirst>> readyInsts;
+    std::list<ListOrderEntry> listOrder;
+    std::vector<bool> queueOnList;
+    std::vector<ListOrderIt> readyIt;
+};
+
+/**
+ * Issue up to width instructions from the select matrix the way
+ * InstructionQueue::scheduleReadyInsts() does.
+ */
+std::vector<InstPtr>
+selectFromMatrix(SelectMatrix &matrix, const std::vector<InstPtr> &entries,
+                 int width, const std::function<bool(unsigned)> &fu_free)
+{
+    std::vector<InstPtr> issued;
+    int entry;
+
+    matrix.beginSelect();
+    while ((int)issued.size() < width &&
+           (entry = matrix.selectOldest()) != SelectMatrix::NoEntry) {
+        const InstPtr &inst = entries[entry];
+        if (fu_free(inst->opClass)) {
+            matrix.clearReady(entry);
+            issued.push_back(inst);
+        } else {
+            matrix.excludeClass(inst->opClass);
+        }
+    }
+    return issued;
+}
+
+} // anonymous namespace
+
+TEST(SelectMatrixTest, AllocateLowEntriesFirst)
+{
+    SelectMatrix matrix(4, 1);
+
+    EXPECT_EQ(0, matrix.allocate(1));
+    EXPECT_EQ(1, matrix.allocate(2));
+    EXPECT_EQ(2, matrix.allocate(3));
+    matrix.release(1);
+    EXPECT_EQ(1, matrix.allocate(4));
+    EXPECT_EQ(3, matrix.allocate(5));
+}
+
+TEST(SelectMatrixTest, SelectOldestReady)
+{
+    SelectMatrix matrix(8, 2);
+
+    // Allocated out of program order, as with several threads.
+    const int e30 = matrix.allocate(30);
+    const int e10 = matrix.allocate(10);
+    const int e20 = matrix.allocate(20);
+
+    EXPECT_FALSE(matrix.anyReady());
+    matrix.beginSelect();
+    EXPECT_EQ(SelectMatrix::NoEntry, matrix.selectOldest());
+
+    matrix.setReady(e30, 0);
+    matrix.setReady(e20, 1);
+    EXPECT_TRUE(matrix.anyReady());
+    EXPECT_TRUE(matrix.isReady(e20));
+    EXPECT_FALSE(matrix.isReady(e10));
+    EXPECT_EQ(1, matrix.numReady(0));
+    EXPECT_EQ(1, matrix.numReady(1));
+
+    matrix.beginSelect();
+    EXPECT_EQ(e20, matrix.selectOldest());
+    matrix.clearReady(e20);
+    EXPECT_EQ(e30, matrix.selectOldest());
+
+    // Excluding a class drops its younger entries from this select.
+    matrix.setReady(e10, 0);
+    matrix.beginSelect();
+    EXPECT_EQ(e10, matrix.selectOldest());
+    matrix.excludeClass(0);
+    EXPECT_EQ(SelectMatrix::NoEntry, matrix.selectOldest());
+}
+
+TEST(SelectMatrixTest, ReleaseClearsReady)
+{
+    SelectMatrix matrix(4, 1);
+
+    const int entry = matrix.allocate(1);
+    matrix.setReady(entry, 0);
+    matrix.release(entry);
+
+    EXPECT_FALSE(matrix.anyReady());
+    EXPECT_EQ(0, matrix.numReady(0));
+}
+
+/**
+ * Squashed instructions leave the matrix when they are squashed,
+ * while the ready lists counted them until select popped them. This
+ * is visible through getNumReady*Instr() and hasReadyInsts().
+ */
+TEST(SelectMatrixTest, SquashedInstsNotReady)
+{
+    SelectMatrix matrix(4, 1);
+    ReadyLists lists(1);
+
+    InstPtr inst(new Inst{1, 0, matrix.allocate(1), true, false});
+    matrix.setReady(inst->entry, 0);
+    lists.addReady(inst);
+
+    inst->squashed = true;
+    matrix.release(inst->entry);
+
+    EXPECT_FALSE(matrix.anyReady());
+    EXPECT_EQ(0, matrix.numReady(0));
+    EXPECT_TRUE(lists.anyReady());
+    EXPECT_EQ(1, lists.numReady(0));
+
+    // Select drops the squashed instruction without issuing it.
+    auto fu_free = [](unsigned op_class) { return true; };
+    EXPECT_TRUE(lists.select(1, fu_free).empty());
+    EXPECT_FALSE(lists.anyReady());
+    EXPECT_EQ(0, lists.numReady(0));
+}
+
+/**
+ * Drive the matrix and the ready lists with the same random stream of
+ * inserts, wakeups, squashes and busy functional units, and check
+ * that they issue the same instructions in the same order.
+ */
+TEST(SelectMatrixTest, SameOrderAsReadyLists)
+{
+    const unsigned num_entries = 96;
+    const unsigned num_classes = 6;
+    const int width = 6;
+
+    SelectMatrix matrix(num_entries, num_classes);
+    ReadyLists lists(num_classes);
+    std::vector<InstPtr> entries(num_entries);
+    std::vector<InstPtr> in_iq;
+
+    std::mt19937 rng(1);
+    InstSeqNum next_seq_num = 1;
+    unsigned num_issued = 0;
+
+    for (int cycle = 0; cycle < 5000; ++cycle) {
+        // Insert a small batch, not necessarily in program order.
+        std::vector<InstSeqNum> batch;
+        const unsigned batch_size = rng() % 5;
+        for (unsigned i = 0; i < batch_size; ++i)
+            batch.push_back(next_seq_num++);
+        std::shuffle(batch.begin(), batch.end(), rng);
+        for (auto seq_num : batch) {
+            if (in_iq.size() == num_entries)
+                break;
+            InstPtr inst(new Inst{seq_num, unsigned(rng() % num_classes),
+                                  matrix.allocate(seq_num), false, false});
+            entries[inst->entry] = inst;
+            in_iq.push_back(inst);
+        }
+
+        // Wake up or squash some of the instructions in the IQ.
+        for (auto it = in_iq.begin(); it != in_iq.end(); ) {
+            const InstPtr &inst = *it;
+            const unsigned action = rng() % 16;
+            if (action == 0) {
+                inst->squashed = true;
+                matrix.release(inst->entry);
+                entries[inst->entry] = nullptr;
+                it = in_iq.erase(it);
+                continue;
+            } else if (action < 6 && !inst->ready) {
+                inst->ready = true;
+                matrix.setReady(inst->entry, inst->opClass);
+                lists.addReady(inst);
+            }
+            ++it;
+        }
+
+        // Both sides see the same functional units in the same order.
+        std::vector<unsigned> fus(num_classes);
+        for (auto &num : fus)
+            num = rng() % 3;
+        auto matrix_fus = fus;
+        auto lists_fus = fus;
+
+        auto issued = selectFromMatrix(matrix, entries, width,
+            [&matrix_fus](unsigned op_class) {
+                return matrix_fus[op_class] && matrix_fus[op_class]--;
+            });
+        auto expected = lists.select(width,
+            [&lists_fus](unsigned op_class) {
+                return lists_fus[op_class] && lists_fus[op_class]--;
+            });
+
+        ASSERT_EQ(expected.size(), issued.size()) << "cycle " << cycle;
+        for (size_t i = 0; i < issued.size(); ++i) {
+            ASSERT_EQ(expected[i]->seqNum, issued[i]->seqNum)
+                << "cycle " << cycle;
+        }
+        num_issued += issued.size();
+
+        for (auto &inst : issued) {
+            matrix.release(inst->entry);
+            entries[inst->entry] = nullptr;
+            in_iq.erase(std::find(in_iq.begin(), in_iq.end(), inst));
+        }
+
+        // The ready counts only differ by squashed instructions.
+        std::vector<unsigned> num_ready(num_classes);
+        for (auto &inst : in_iq)
+            num_ready[inst->opClass] += inst->ready;
+        for (unsigned op_class = 0; op_class < num_classes; ++op_class) {
+            EXPECT_EQ(num_ready[op_class], matrix.numReady(op_class));
+            EXPECT_LE(matrix.numReady(op_class), lists.numReady(op_class));
+        }
+        EXPECT_EQ(std::any_of(num_ready.begin(), num_ready.end(),
+                              [](unsigned num) { return num != 0; }),
+                  matrix.anyReady());
+    }
+
+    // Make sure the random stream actually exercised select.
+    EXPECT_GT(num_issued, 1000);
+}
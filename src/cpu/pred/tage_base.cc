@@ -157,6 +157,31 @@ TAGEBase::initFoldedHistories(ThreadHistory & history)
     }
 }
 
+void
+TAGEBase::updateFoldedHistories(ThreadHistory & history)
+{
+    const uint8_t *h = history.gHist;
+    const unsigned in = h[0];
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const unsigned out = h[history.computeIndices[i].origLength];
+        history.computeIndices[i].update(in, out);
+        history.computeTags[0][i].update(in, out);
+        history.computeTags[1][i].update(in, out);
+    }
+}
+
+void
+TAGEBase::restoreFoldedHistories(ThreadHistory & history,
+                                 const BranchInfo *bi)
+{
+    for (int i = 1; i <= nHistoryTables; i++) {
+        history.computeIndices[i].comp = bi->ci[i];
+        history.computeTags[0][i].comp = bi->ct0[i];
+        history.computeTags[1][i].comp = bi->ct1[i];
+    }
+    updateFoldedHistories(history);
+}
+
 void
 TAGEBase::buildTageTables()
 {
@@ -187,14 +212,7 @@ TAGEBase::btbUpdate(ThreadID tid, Addr branch_pc, BranchInfo* &bi)
         DPRINTF(Tage, "BTB miss resets prediction: %lx\n", branch_pc);
         assert(tHist.gHist == &tHist.globalHistory[tHist.ptGhist]);
         tHist.gHist[0] = 0;
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].comp = bi->ci[i];
-            tHist.computeTags[0][i].comp = bi->ct0[i];
-            tHist.computeTags[1][i].comp = bi->ct1[i];
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        restoreFoldedHistories(tHist, bi);
     }
 }
 
@@ -602,17 +620,14 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
     }
 
     //prepare next index and tag computations for user branchs
-    for (int i = 1; i <= nHistoryTables; i++)
-    {
-        if (speculative) {
+    if (speculative) {
+        for (int i = 1; i <= nHistoryTables; i++) {
             bi->ci[i]  = tHist.computeIndices[i].comp;
             bi->ct0[i] = tHist.computeTags[0][i].comp;
             bi->ct1[i] = tHist.computeTags[1][i].comp;
         }
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    updateFoldedHistories(tHist);
     DPRINTF(Tage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
@@ -636,14 +651,7 @@ TAGEBase::squash(ThreadID tid, bool taken, TAGEBase::BranchInfo *bi,
     tHist.ptGhist = bi->ptGhist;
     tHist.gHist = &(tHist.globalHistory[tHist.ptGhist]);
     tHist.gHist[0] = (taken ? 1 : 0);
-    for (int i = 1; i <= nHistoryTables; i++) {
-        tHist.computeIndices[i].comp = bi->ci[i];
-        tHist.computeTags[0][i].comp = bi->ct0[i];
-        tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
-    }
+    restoreFoldedHistories(tHist, bi);
 }
 
 void
@@ -69,12 +69,13 @@ class TAGEBase : public SimObject
     // Prediction Structures
 
     // Tage Entry
+    // The tag comes first to avoid padding, entries take 4 bytes
     struct TageEntry
     {
-        int8_t ctr;
         uint16_t tag;
+        int8_t ctr;
         uint8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
+        TageEntry() : tag(0), ctr(0), u(0) { }
     };
 
     // Folded History Table - compressed history
@@ -83,6 +84,7 @@ class TAGEBase : public SimObject
     struct FoldedHistory
     {
         unsigned comp;
+        unsigned mask;
         int compLength;
         int origLength;
         int outpoint;
@@ -98,14 +100,25 @@ class TAGEBase : public SimObject
             origLength = original_length;
             compLength = compressed_length;
             outpoint = original_length % compressed_length;
+            mask = (ULL(1) << compressed_length) - 1;
         }
 
         void update(uint8_t * h)
         {
-            comp = (comp << 1) | h[0];
-            comp ^= h[origLength] << outpoint;
+            update(h[0], h[origLength]);
+        }
+
+        /**
+         * Shift a new outcome into the folded history.
+         * @param in Outcome entering the original history.
+         * @param out Outcome leaving the original history.
+         */
+        void update(unsigned in, unsigned out)
+        {
+            comp = (comp << 1) | in;
+            comp ^= out << outpoint;
             comp ^= (comp >> compLength);
-            comp &= (ULL(1) << compLength) - 1;
+            comp &= mask;
         }
     };
 
@@ -463,6 +476,24 @@ class TAGEBase : public SimObject
      */
     virtual void initFoldedHistories(ThreadHistory & history);
 
+    /**
+     * Shift the most recent branch outcome into all folded histories
+     * of a thread. The index and tag histories of a table fold the same
+     * original history, so they share the outcomes entering and leaving
+     * it.
+     * @param history Histories of the thread.
+     */
+    void updateFoldedHistories(ThreadHistory & history);
+
+    /**
+     * Restore the folded histories of a thread to their state before a
+     * branch and shift the most recent outcome into them.
+     * @param history Histories of the thread.
+     * @param bi Branch info holding the folded histories to restore.
+     */
+    void restoreFoldedHistories(ThreadHistory & history,
+                                const BranchInfo *bi);
+
     int *histLengths;
     int *tableIndices;
     int *tableTags;
@@ -61,6 +61,11 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    bb_cache_blocks = Param.Unsigned(0, "Number of pre-decoded basic blocks "
+        "to keep for replay without fetching, e.g., when fast-forwarding "
+        "(0 to disable, not used with multiple threads or when simulating "
+        "icache stalls). Replayed instructions don't access the icache, "
+        "which changes icache and memory stats.")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
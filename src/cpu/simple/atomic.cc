@@ -83,6 +83,8 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      bbCache(p->numThreads == 1 && !p->simulate_inst_stalls ?
+              p->bb_cache_blocks : 0),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
@@ -153,6 +155,9 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory may have been changed behind our back while drained.
+    bbCache.flush();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -211,6 +216,8 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
 
     // The tick event should have been descheduled by drain()
     assert(!tickEvent.scheduled());
+
+    bbCache.flush();
 }
 
 void
@@ -496,6 +503,11 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
         if (predicate && fault == NoFault) {
             bool do_access = true;  // flag to suppress cache access
 
+            // A fragment never crosses a cache line, so its first byte
+            // tells which page it writes to.
+            if (bbCache.enabled())
+                bbCache.write(req->getPaddr());
+
             if (req->isLLSC()) {
                 assert(curr_frag_id == 0);
                 do_access =
@@ -602,6 +614,9 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
     Fault fault = thread->dtb->translateAtomic(req, thread->getTC(),
                                                       BaseTLB::Write);
 
+    if (fault == NoFault && bbCache.enabled())
+        bbCache.write(req->getPaddr());
+
     // Now do the access.
     if (fault == NoFault && !req->getFlags().isSet(Request::NO_ACCESS)) {
         // We treat AMO accesses as Write accesses with SwapReq command
@@ -673,6 +688,19 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
+
+        // Replay the next instruction of a cached basic block instead of
+        // fetching and decoding it again.
+        const BasicBlockCache::Entry *cached = nullptr;
+        if (needToFetch && bbCache.enabled() && t_info.fetchOffset == 0) {
+            cached = bbCache.next(pcState);
+            if (cached) {
+                needToFetch = false;
+                thread->pcState(cached->decodedPC);
+                thread->decoder.reset();
+            }
+        }
+
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
@@ -706,7 +734,18 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            preExecute(cached ? cached->inst : StaticInst::nullStaticInstPtr);
+
+            if (bbCache.enabled()) {
+                if (needToFetch && !t_info.stayAtPC) {
+                    bbCache.fetched(pcState, thread->pcState(),
+                                    curMacroStaticInst ? curMacroStaticInst :
+                                    curStaticInst, ifetch_req->getVaddr(),
+                                    ifetch_req->getPaddr());
+                }
+                if (curStaticInst)
+                    bbCache.executed(curStaticInst);
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
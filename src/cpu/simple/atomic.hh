@@ -44,6 +44,7 @@
 #define __CPU_SIMPLE_ATOMIC_HH__
 
 #include "cpu/simple/base.hh"
+#include "cpu/simple/bb_cache.hh"
 #include "cpu/simple/exec_context.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
@@ -67,6 +68,9 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
+    /** Pre-decoded instruction sequences, replayed without fetching. */
+    BasicBlockCache bbCache;
+
     // main simulation loop (one cycle)
     void tick();
 
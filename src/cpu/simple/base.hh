@@ -130,7 +130,16 @@ class BaseSimpleCPU : public BaseCPU
 
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
-    void preExecute();
+    /**
+     * Prepare the next instruction for execution.
+     *
+     * @param predecoded Instruction to use instead of decoding the
+     *                   fetched bytes, e.g., from a basic block cache.
+     *                   The caller is responsible for setting the PC
+     *                   state the decoder would have produced.
+     */
+    void preExecute(const StaticInstPtr &predecoded =
+                    StaticInst::nullStaticInstPtr);
     void postExecute();
     void advancePC(const Fault &fault);
 
@@ -0,0 +1,117 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/bb_cache.hh"
+
+#include <utility>
+
+BasicBlockCache::BasicBlockCache(unsigned max_blocks)
+    : maxBlocks(max_blocks), active(nullptr), cursor(0), recording(false),
+      recordedPage(0)
+{
+}
+
+bool
+BasicBlockCache::endsBlock(const StaticInstPtr &inst)
+{
+    return inst->isSerializing() || inst->isNonSpeculative() ||
+        inst->isSquashAfter() || inst->isSyscall() || inst->isQuiesce() ||
+        inst->isIprAccess();
+}
+
+void
+BasicBlockCache::fetched(const TheISA::PCState &fetch_pc,
+                         const TheISA::PCState &decoded_pc,
+                         const StaticInstPtr &inst,
+                         Addr fetch_addr, Addr fetch_paddr)
+{
+    const Addr page = pageOf(fetch_pc.instAddr());
+    const bool same_page = pageOf(fetch_addr) == page;
+
+    if (recording) {
+        if (same_page && page == recordedPage &&
+            recordedBlock.entries.size() < maxBlockSize) {
+            recordedBlock.entries.push_back({ fetch_pc, decoded_pc, inst });
+            if (endsBlock(inst))
+                finishRecording();
+            return;
+        }
+        finishRecording();
+    }
+
+    const Addr phys_page = fetch_paddr - (fetch_addr - pageOf(fetch_addr));
+
+    auto it = blocks.find(fetch_pc.instAddr());
+    if (it != blocks.end()) {
+        const Block &block = it->second;
+        const Entry &first = block.entries.front();
+        if (block.physPage == phys_page && first.fetchPC == fetch_pc &&
+            first.decodedPC == decoded_pc && first.inst == inst) {
+            active = &block.entries;
+            cursor = 1;
+            return;
+        }
+        // The code or its mapping changed, record the block again.
+        blocks.erase(it);
+    }
+
+    if (!same_page)
+        return;
+
+    recording = true;
+    recordedPage = page;
+    recordedBlock.physPage = phys_page;
+    recordedBlock.entries.clear();
+    recordedBlock.entries.push_back({ fetch_pc, decoded_pc, inst });
+    if (endsBlock(inst))
+        finishRecording();
+}
+
+void
+BasicBlockCache::finishRecording()
+{
+    recording = false;
+
+    // Single instructions don't save anything.
+    if (recordedBlock.entries.size() < 2)
+        return;
+
+    if (blocks.size() >= maxBlocks)
+        flush();
+
+    const Addr start = recordedBlock.entries.front().fetchPC.instAddr();
+    physPages.insert(recordedBlock.physPage);
+    blocks[start] = std::move(recordedBlock);
+    recordedBlock.entries.clear();
+}
+
+void
+BasicBlockCache::flush()
+{
+    blocks.clear();
+    physPages.clear();
+    active = nullptr;
+    recording = false;
+}
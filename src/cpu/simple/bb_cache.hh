@@ -0,0 +1,171 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_BB_CACHE_HH__
+#define __CPU_SIMPLE_BB_CACHE_HH__
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "arch/isa_traits.hh"
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+
+/**
+ * Cache of pre-decoded instruction sequences for the atomic CPU.
+ *
+ * A block is recorded while instructions are fetched and decoded the
+ * normal way. It stores, for every instruction, the PC state it was
+ * fetched at, the PC state the decoder produced and the decoded
+ * (macro-)instruction. A block ends after an instruction that may change
+ * translations or decoding (serializing, non-speculative, syscalls,
+ * ...), when leaving the page of its first instruction or when it
+ * reaches its maximum length. Since each entry is keyed by the full PC
+ * state, a block can follow taken branches as long as they stay on the
+ * same page.
+ *
+ * The first instruction of a block is always fetched and decoded, which
+ * validates the translation of the page, the instruction bytes and the
+ * decoder mode. The rest of the block is then replayed without touching
+ * the ITB, the instruction port or the decoder for as long as the PC
+ * follows the recorded path. Since replayed instructions don't access
+ * the instruction port, instruction cache and memory stats differ from
+ * a run without the cache.
+ *
+ * Stores by the CPU itself to a physical page holding cached code flush
+ * the cache, whatever virtual address they use; stores by other agents
+ * in the middle of a block are not detected.
+ */
+class BasicBlockCache
+{
+  public:
+    struct Entry
+    {
+        /** PC state the instruction was fetched at. */
+        TheISA::PCState fetchPC;
+        /** PC state after decoding the instruction. */
+        TheISA::PCState decodedPC;
+        /** Decoded instruction, a macro-op for microcoded instructions. */
+        StaticInstPtr inst;
+    };
+
+    /**
+     * @param max_blocks Number of blocks kept before the cache is
+     *                   flushed, 0 disables the cache.
+     */
+    BasicBlockCache(unsigned max_blocks);
+
+    bool enabled() const { return maxBlocks != 0; }
+
+    /**
+     * Return the next instruction of the active block if the thread is
+     * at the PC state it was recorded at, leave the block otherwise.
+     */
+    const Entry *
+    next(const TheISA::PCState &pc)
+    {
+        if (active && cursor < active->size() &&
+            (*active)[cursor].fetchPC == pc) {
+            return &(*active)[cursor++];
+        }
+        active = nullptr;
+        return nullptr;
+    }
+
+    /**
+     * Notify the cache of an instruction that has been fetched and
+     * decoded normally. This either enters a matching cached block or
+     * extends the block being recorded.
+     *
+     * @param fetch_pc PC state the instruction was fetched at.
+     * @param decoded_pc PC state after decoding.
+     * @param inst Decoded (macro-)instruction.
+     * @param fetch_addr Virtual address of the last fetch.
+     * @param fetch_paddr Physical address of the last fetch.
+     */
+    void fetched(const TheISA::PCState &fetch_pc,
+                 const TheISA::PCState &decoded_pc,
+                 const StaticInstPtr &inst,
+                 Addr fetch_addr, Addr fetch_paddr);
+
+    /** Notify the cache of every executed (micro-)instruction. */
+    void
+    executed(const StaticInstPtr &inst)
+    {
+        if (recording && endsBlock(inst))
+            finishRecording();
+    }
+
+    /**
+     * Flush the cache if a store hits a page holding cached code.
+     *
+     * @param paddr Physical address of the store after translation.
+     */
+    void
+    write(Addr paddr)
+    {
+        if (!physPages.empty() && physPages.count(pageOf(paddr)))
+            flush();
+    }
+
+    /** Drop all blocks, e.g., when memory may have changed. */
+    void flush();
+
+  private:
+    struct Block
+    {
+        /** Physical page the block was recorded from. */
+        Addr physPage;
+        std::vector<Entry> entries;
+    };
+
+    /** Maximum number of instructions in a block. */
+    static const size_t maxBlockSize = 64;
+
+    static Addr pageOf(Addr addr) { return addr & ~(TheISA::PageBytes - 1); }
+
+    static bool endsBlock(const StaticInstPtr &inst);
+
+    void finishRecording();
+
+    const unsigned maxBlocks;
+
+    /** Cached blocks indexed by the address of their first instruction. */
+    std::unordered_map<Addr, Block> blocks;
+    /** Physical pages holding cached code. */
+    std::unordered_set<Addr> physPages;
+
+    /** Block being replayed and the index of its next instruction. */
+    const std::vector<Entry> *active;
+    size_t cursor;
+
+    bool recording;
+    Block recordedBlock;
+    Addr recordedPage;
+};
+
+#endif // __CPU_SIMPLE_BB_CACHE_HH__
@@ -83,6 +83,10 @@ class BaseTrafficGen(ClockedObject):
     progress_check = Param.Latency('1ms', "Time before exiting " \
                                    "due to lack of progress")
 
+    # Decompress and parse trace files on a helper thread, ahead of the
+    # simulation consuming the packets
+    prefetchTraces = Param.Bool(True, "Read traces on a helper thread")
+
     # Generator type used for applying Stream and/or Substream IDs to requests
     stream_gen = Param.StreamGenType('none',
         "Generator for adding Stream and/or Substream ID's to requests")
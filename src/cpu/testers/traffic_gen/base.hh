@@ -88,6 +88,11 @@ class BaseTrafficGen : public ClockedObject
      */
     const Tick progressCheck;
 
+    /**
+     * Parse trace files ahead of time on a helper thread.
+     */
+    const bool prefetchTraces;
+
   private:
     /**
      * Receive a retry from the neighbouring port and attempt to
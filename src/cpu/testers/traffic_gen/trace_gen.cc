@@ -49,16 +49,20 @@
 #include "debug/TrafficGen.hh"
 #include "proto/packet.pb.h"
 
-TraceGen::InputStream::InputStream(const std::string& filename)
+TraceGen::InputStream::InputStream(const std::string& filename,
+                                   bool prefetch)
     : trace(filename)
 {
+    if (prefetch)
+        prefetcher.reset(new ProtoPrefetcher<ProtoMessage::Packet>(trace));
     init();
 }
 
 void
 TraceGen::InputStream::init()
 {
-    // Create a protobuf message for the header and read it from the stream
+    // Create a protobuf message for the header and read it from the
+    // stream, the prefetcher only starts reading packets after it
     ProtoMessage::PacketHeader header_msg;
     if (!trace.read(header_msg)) {
         panic("Failed to read packet header from trace\n");
@@ -71,7 +75,10 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    if (prefetcher)
+        prefetcher->reset();
+    else
+        trace.reset();
     init();
 }
 
@@ -79,7 +86,7 @@ bool
 TraceGen::InputStream::read(TraceElement& element)
 {
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (prefetcher ? prefetcher->read(pkt_msg) : trace.read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
@@ -49,10 +49,13 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
+#include "proto/packet.pb.h"
 #include "proto/protoio.hh"
 
 /**
@@ -115,14 +118,18 @@ class TraceGen : public BaseGen
         /// Input file stream for the protobuf trace
         ProtoInputStream trace;
 
+        /// Optional helper thread decompressing and parsing packets ahead
+        std::unique_ptr<ProtoPrefetcher<ProtoMessage::Packet>> prefetcher;
+
       public:
 
         /**
          * Create a trace input stream for a given file name.
          *
          * @param filename Path to the file to read from
+         * @param prefetch Parse packets ahead on a helper thread
          */
-        InputStream(const std::string& filename);
+        InputStream(const std::string& filename, bool prefetch);
 
         /**
          * Reset the stream such that it can be played once
@@ -157,11 +164,12 @@ class TraceGen : public BaseGen
      * @param _duration duration of this state before transitioning
      * @param trace_file File to read the transactions from
      * @param addr_offset Positive offset to add to trace address
+     * @param prefetch Parse the trace ahead on a helper thread
      */
     TraceGen(SimObject &obj, MasterID master_id, Tick _duration,
-             const std::string& trace_file, Addr addr_offset)
+             const std::string& trace_file, Addr addr_offset, bool prefetch)
         : BaseGen(obj, master_id, _duration),
-          trace(trace_file),
+          trace(trace_file, prefetch),
           tickOffset(0),
           addrOffset(addr_offset),
           traceComplete(false)
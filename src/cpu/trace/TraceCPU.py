@@ -81,6 +81,14 @@ class TraceCPU(BaseCPU):
     enableEarlyExit = Param.Bool(False, "Exit when any one Trace CPU "\
                                  "completes execution")
 
+    # Event queue of the memory system. Trace CPUs on other event queues
+    # replay their traces in parallel and migrate to this queue to send
+    # requests to memory.
+    memEventqIndex = Param.UInt32(0, "Event queue of the memory system")
+
+    # Parse trace records ahead of their use on a helper thread
+    prefetchTraces = Param.Bool(True, "Read traces on a helper thread")
+
     # If progress msg interval is set to a non-zero value, it is treated as
     # the interval of committed instructions at which an info message is
     # printed.
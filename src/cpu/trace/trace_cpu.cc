@@ -44,7 +44,7 @@
 #include "sim/sim_exit.hh"
 
 // Declare and initialize the static counter for number of trace CPUs.
-int TraceCPU::numTraceCPUs = 0;
+std::atomic<int> TraceCPU::numTraceCPUs(0);
 
 TraceCPU::TraceCPU(TraceCPUParams *params)
     :   BaseCPU(params),
@@ -54,15 +54,16 @@ TraceCPU::TraceCPU(TraceCPUParams *params)
         dataMasterID(params->system->getMasterId(this, "data")),
         instTraceFile(params->instTraceFile),
         dataTraceFile(params->dataTraceFile),
-        icacheGen(*this, ".iside", icachePort, instMasterID, instTraceFile),
+        icacheGen(*this, ".iside", icachePort, instMasterID, instTraceFile,
+                  params->prefetchTraces),
         dcacheGen(*this, ".dside", dcachePort, dataMasterID, dataTraceFile,
                   params),
         icacheNextEvent([this]{ schedIcacheNext(); }, name()),
         dcacheNextEvent([this]{ schedDcacheNext(); }, name()),
         oneTraceComplete(false),
         traceOffset(0),
-        execCompleteEvent(nullptr),
         enableEarlyExit(params->enableEarlyExit),
+        memEventQueue(getEventQueue(params->memEventqIndex)),
         progressMsgInterval(params->progressMsgInterval),
         progressMsgThreshold(params->progressMsgInterval)
 {
@@ -140,17 +141,6 @@ TraceCPU::init()
     // send its first request at the first event and schedule subsequent
     // events using a relative tick delta
     dcacheGen.adjustInitTraceOffset(traceOffset);
-
-    // If the Trace CPU simulation is configured to exit on any one trace
-    // completion then we don't need a counted event to count down all Trace
-    // CPUs in the system. If not then instantiate a counted event.
-    if (!enableEarlyExit) {
-        // The static counter for number of Trace CPUs is correctly set at
-        // this point so create an event and pass it.
-        execCompleteEvent = new CountedExitEvent("end of all traces reached.",
-                                                 numTraceCPUs);
-    }
-
 }
 
 void
@@ -192,6 +182,13 @@ TraceCPU::schedDcacheNext()
     }
 }
 
+bool
+TraceCPU::sendTimingReq(MasterPort& port, PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(memEventQueue);
+    return port.sendTimingReq(pkt);
+}
+
 void
 TraceCPU::checkAndSchedExitEvent()
 {
@@ -203,12 +200,12 @@ TraceCPU::checkAndSchedExitEvent()
         inform("%s: Execution complete.\n", name());
         // If the replay is configured to exit early, that is when any one
         // execution is complete then exit immediately and return. Otherwise,
-        // schedule the counted exit that counts down completion of each Trace
-        // CPU.
+        // count down the completion of each Trace CPU and exit with the last
+        // one.
         if (enableEarlyExit) {
             exitSimLoop("End of trace reached");
-        } else {
-            schedule(*execCompleteEvent, curTick());
+        } else if (--numTraceCPUs == 0) {
+            exitSimLoop("end of all traces reached.");
         }
     }
 }
@@ -475,7 +472,7 @@ TraceCPU::ElasticDataGen::execute()
                 panic("Retry packet's seqence number does not match "
                       "the first node in the readyList.\n");
             }
-            if (port.sendTimingReq(retryPkt)) {
+            if (owner.sendTimingReq(port, retryPkt)) {
                 ++numRetrySucceeded;
                 retryPkt = nullptr;
             }
@@ -679,7 +676,7 @@ TraceCPU::ElasticDataGen::executeMemReq(GraphNode* node_ptr)
     pkt->dataDynamic(pkt_data);
 
     // Call MasterPort method to send a timing request for this packet
-    bool success = port.sendTimingReq(pkt);
+    bool success = owner.sendTimingReq(port, pkt);
     ++numSendAttempted;
 
     if (!success) {
@@ -1067,7 +1064,7 @@ TraceCPU::FixedRetryGen::tryNext()
 
         DPRINTF(TraceCPUInst, "Trying to send retry packet.\n");
 
-        if (!port.sendTimingReq(retryPkt)) {
+        if (!owner.sendTimingReq(port, retryPkt)) {
             // Still blocked! This should never occur.
             DPRINTF(TraceCPUInst, "Retry packet sending failed.\n");
             return false;
@@ -1168,7 +1165,7 @@ TraceCPU::FixedRetryGen::send(Addr addr, unsigned size, const MemCmd& cmd,
     }
 
     // Call MasterPort method to send a timing request for this packet
-    bool success = port.sendTimingReq(pkt);
+    bool success = owner.sendTimingReq(port, pkt);
     if (!success) {
         // If it fails, save the packet to retry when a retry is signalled by
         // the cache
@@ -1226,6 +1223,7 @@ TraceCPU::IcachePort::recvTimingResp(PacketPtr pkt)
 void
 TraceCPU::IcachePort::recvReqRetry()
 {
+    EventQueue::ScopedMigration migrate(owner->eventQueue());
     owner->icacheRetryRecvd();
 }
 
@@ -1241,6 +1239,7 @@ TraceCPU::DcachePort::recvTimingResp(PacketPtr pkt)
 {
     // Handle the responses for data memory requests which is done inside the
     // elastic data generator
+    EventQueue::ScopedMigration migrate(owner->eventQueue());
     owner->dcacheRecvTimingResp(pkt);
     // After processing the response delete the packet to free
     // memory
@@ -1252,12 +1251,13 @@ TraceCPU::DcachePort::recvTimingResp(PacketPtr pkt)
 void
 TraceCPU::DcachePort::recvReqRetry()
 {
+    EventQueue::ScopedMigration migrate(owner->eventQueue());
     owner->dcacheRetryRecvd();
 }
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
     const std::string& filename,
-    const double time_multiplier)
+    const double time_multiplier, bool prefetch)
     : trace(filename),
       timeMultiplier(time_multiplier),
       microOpCount(0)
@@ -1276,19 +1276,27 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    // Records are parsed ahead once the header has been read
+    if (prefetch)
+        prefetcher.reset(
+            new ProtoPrefetcher<ProtoMessage::InstDepRecord>(trace));
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
-    trace.reset();
+    if (prefetcher)
+        prefetcher->reset();
+    else
+        trace.reset();
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
     ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (prefetcher ? prefetcher->read(pkt_msg) : trace.read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1470,7 +1478,8 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
     return Record::RecordType_Name(type);
 }
 
-TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
+TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename,
+                                                  bool prefetch)
     : trace(filename)
 {
     // Create a protobuf message for the header and read it from the stream
@@ -1483,19 +1492,26 @@ TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
                   header_msg.tick_freq());
         }
     }
+
+    // Messages are parsed ahead once the header has been read
+    if (prefetch)
+        prefetcher.reset(new ProtoPrefetcher<ProtoMessage::Packet>(trace));
 }
 
 void
 TraceCPU::FixedRetryGen::InputStream::reset()
 {
-    trace.reset();
+    if (prefetcher)
+        prefetcher->reset();
+    else
+        trace.reset();
 }
 
 bool
 TraceCPU::FixedRetryGen::InputStream::read(TraceElement* element)
 {
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (prefetcher ? prefetcher->read(pkt_msg) : trace.read(pkt_msg)) {
         element->cmd = pkt_msg.cmd();
         element->addr = pkt_msg.addr();
         element->blocksize = pkt_msg.size();
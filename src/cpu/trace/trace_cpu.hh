@@ -43,7 +43,9 @@
 #define __CPU_TRACE_TRACE_CPU_HH__
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -136,9 +138,14 @@
  * Strictly-ordered requests are skipped and the dependencies on such requests
  * are handled by simply marking them complete immediately.
  *
- * A CountedExitEvent that contains a static int belonging to the Trace CPU
- * class as a down counter is used to implement multi Trace CPU simulation
- * exit.
+ * A static atomic counter of the Trace CPUs that haven't completed yet is
+ * used to implement multi Trace CPU simulation exit.
+ *
+ * Trace CPUs can be placed on separate event queues to replay traces in
+ * parallel. The memory system they are connected to is then expected to
+ * be on a single boundary event queue, memEventqIndex, and the Trace CPU
+ * migrates to that queue to send requests and back to its own queue to
+ * handle responses and retries.
  */
 
 class TraceCPU : public BaseCPU
@@ -398,14 +405,18 @@ class TraceCPU : public BaseCPU
             // Input file stream for the protobuf trace
             ProtoInputStream trace;
 
+            // Optional helper thread parsing messages ahead of time
+            std::unique_ptr<ProtoPrefetcher<ProtoMessage::Packet>> prefetcher;
+
           public:
 
             /**
              * Create a trace input stream for a given file name.
              *
              * @param filename Path to the file to read from
+             * @param prefetch Parse messages ahead on a helper thread
              */
-            InputStream(const std::string& filename);
+            InputStream(const std::string& filename, bool prefetch);
 
             /**
              * Reset the stream such that it can be played once
@@ -428,11 +439,11 @@ class TraceCPU : public BaseCPU
         /* Constructor */
         FixedRetryGen(TraceCPU& _owner, const std::string& _name,
                    MasterPort& _port, MasterID master_id,
-                   const std::string& trace_file)
+                   const std::string& trace_file, bool prefetch)
             : owner(_owner),
               port(_port),
               masterID(master_id),
-              trace(trace_file),
+              trace(trace_file, prefetch),
               genName(owner.name() + ".fixedretry" + _name),
               retryPkt(nullptr),
               delta(0),
@@ -800,6 +811,10 @@ class TraceCPU : public BaseCPU
             /** Input file stream for the protobuf trace */
             ProtoInputStream trace;
 
+            /** Optional helper thread parsing records ahead of time */
+            std::unique_ptr<ProtoPrefetcher<ProtoMessage::InstDepRecord>>
+                prefetcher;
+
             /**
              * A multiplier for the compute delays in the trace to modulate
              * the Trace CPU frequency either up or down. The Trace CPU's
@@ -823,9 +838,10 @@ class TraceCPU : public BaseCPU
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param prefetch Parse records ahead on a helper thread
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier, bool prefetch);
 
             /**
              * Reset the stream such that it can be played once
@@ -859,7 +875,8 @@ class TraceCPU : public BaseCPU
             : owner(_owner),
               port(_port),
               masterID(master_id),
-              trace(trace_file, 1.0 / params->freqMultiplier),
+              trace(trace_file, 1.0 / params->freqMultiplier,
+                    params->prefetchTraces),
               genName(owner.name() + ".elastic" + _name),
               retryPkt(nullptr),
               traceComplete(false),
@@ -1090,6 +1107,15 @@ class TraceCPU : public BaseCPU
     /** This is called when either generator finishes executing from the trace */
     void checkAndSchedExitEvent();
 
+    /**
+     * Send a timing request on the event queue of the memory system.
+     *
+     * @param port Port to send the request on
+     * @param pkt Packet to send
+     * @return true if the request was accepted
+     */
+    bool sendTimingReq(MasterPort& port, PacketPtr pkt);
+
     /** Set to true when one of the generators finishes replaying its trace. */
     bool oneTraceComplete;
 
@@ -1102,26 +1128,23 @@ class TraceCPU : public BaseCPU
     Tick traceOffset;
 
     /**
-     * Number of Trace CPUs in the system used as a shared variable and passed
-     * to the CountedExitEvent event used for counting down exit events.  It is
-     * incremented in the constructor call so that the total is arrived at
-     * automatically.
+     * Number of Trace CPUs in the system that haven't completed their
+     * execution. It is incremented in the constructor call so that the total
+     * is arrived at automatically, and decremented by each Trace CPU on
+     * completion, possibly from different event queue threads. Simulation
+     * exits when it reaches zero.
      */
-    static int numTraceCPUs;
-
-   /**
-    * A CountedExitEvent which when serviced decrements the counter. A sim
-    * exit event is scheduled when the counter equals zero, that is all
-    * instances of Trace CPU have had their execCompleteEvent serviced.
-    */
-    CountedExitEvent *execCompleteEvent;
+    static std::atomic<int> numTraceCPUs;
 
     /**
      * Exit when any one Trace CPU completes its execution. If this is
-     * configured true then the execCompleteEvent is not scheduled.
+     * configured true then the counter of Trace CPUs is not used.
      */
     const bool enableEarlyExit;
 
+    /** Event queue of the memory system the Trace CPU is connected to. */
+    EventQueue *const memEventQueue;
+
     /**
       * Interval of committed instructions specified by the user at which a
       * progress info message is printed
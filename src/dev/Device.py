@@ -92,6 +92,9 @@ class DmaDevice(PioDevice):
     ssid = Param.Unsigned(0,
         "Substream identifier used by an IOMMU to distinguish amongst "
         "several devices attached to it")
+    coalesce_dma = Param.Bool(False,
+        "Complete large DMA reads through a back door to memory in the "
+        "atomic_noncaching memory mode, bypassing the memory's stats")
 
     def addIommuProperty(self, state, node):
         """
@@ -40,6 +40,8 @@
 
 #include "dev/arm/hdlcd.hh"
 
+#include <algorithm>
+
 #include "base/output.hh"
 #include "base/trace.hh"
 #include "base/vnc/vncinput.hh"
@@ -533,6 +535,24 @@ HDLcd::pxlNext(Pixel &p)
     }
 }
 
+unsigned
+HDLcd::pxlNext(Pixel *p, unsigned count)
+{
+    // Convert as many pixels as the FIFO holds, a batch at a time
+    count = std::min<size_t>(count, dmaEngine->size() / conv.length);
+
+    uint8_t pixel_data[64 * MAX_PIXEL_SIZE];
+    const unsigned batch_size(sizeof(pixel_data) / conv.length);
+    for (unsigned done = 0; done < count; ) {
+        const unsigned batch(std::min(count - done, batch_size));
+        dmaEngine->get(pixel_data, batch * conv.length);
+        conv.toPixels(pixel_data, p + done, batch);
+        done += batch;
+    }
+
+    return count;
+}
+
 void
 HDLcd::pxlVSyncBegin()
 {
@@ -581,8 +601,7 @@ HDLcd::pxlFrameDone()
         }
 
         assert(pic);
-        pic->stream()->seekp(0);
-        imgWriter->write(*pic->stream());
+        imgWriter->update(*pic->stream());
     }
 }
 
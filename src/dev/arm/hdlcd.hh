@@ -270,6 +270,7 @@ class HDLcd: public AmbaDmaDevice
 
   public: // Pixel pump callbacks
     bool pxlNext(Pixel &p);
+    unsigned pxlNext(Pixel *p, unsigned count);
     void pxlVSyncBegin();
     void pxlVSyncEnd();
     void pxlUnderrun();
@@ -331,6 +332,9 @@ class HDLcd: public AmbaDmaDevice
 
       protected:
         bool nextPixel(Pixel &p) override { return parent.pxlNext(p); }
+        unsigned nextPixels(Pixel *p, unsigned count) override {
+            return parent.pxlNext(p, count);
+        }
 
         void onVSyncBegin() override { return parent.pxlVSyncBegin(); }
         void onVSyncEnd() override { return parent.pxlVSyncEnd(); }
@@ -531,8 +531,7 @@ Pl111::dmaDone()
                                     true);
 
             assert(pic);
-            pic->stream()->seekp(0);
-            bmp.write(*pic->stream());
+            bmp.update(*pic->stream());
         }
 
         // schedule the next read based on when the last frame started
@@ -45,9 +45,9 @@
 
 #include "dev/dma_device.hh"
 
+#include <cstring>
 #include <utility>
 
-#include "base/chunk_generator.hh"
 #include "debug/DMA.hh"
 #include "debug/Drain.hh"
 #include "mem/port_proxy.hh"
@@ -55,15 +55,36 @@
 #include "sim/system.hh"
 
 DmaPort::DmaPort(ClockedObject *dev, System *s,
-                 uint32_t sid, uint32_t ssid)
+                 uint32_t sid, uint32_t ssid, bool coalesce)
     : MasterPort(dev->name() + ".dma", dev),
       device(dev), sys(s), masterId(s->getMasterId(dev)),
       sendEvent([this]{ sendDma(); }, dev->name()),
       pendingCount(0), inRetry(false),
       defaultSid(sid),
-      defaultSSid(ssid)
+      defaultSSid(ssid),
+      coalesce(coalesce)
 { }
 
+PacketPtr
+DmaPort::DmaReqState::createPacket()
+{
+    RequestPtr req = std::make_shared<Request>(
+        gen.addr(), gen.size(), flags, masterId);
+
+    req->setStreamId(sid);
+    req->setSubStreamId(ssid);
+
+    req->taskId(ContextSwitchTaskId::DMA);
+    PacketPtr pkt = new Packet(req, cmd);
+
+    // Increment the data pointer on a write
+    if (data)
+        pkt->dataStatic(data + gen.complete());
+
+    pkt->senderState = this;
+    return pkt;
+}
+
 void
 DmaPort::handleResp(PacketPtr pkt, Tick delay)
 {
@@ -103,7 +124,7 @@ DmaPort::handleResp(PacketPtr pkt, Tick delay)
     delete pkt;
 
     // we might be drained at this point, if so signal the drain event
-    if (pendingCount == 0)
+    if (pendingCount == 0 && transmitList.empty())
         signalDrainDone();
 }
 
@@ -120,7 +141,7 @@ DmaPort::recvTimingResp(PacketPtr pkt)
 }
 
 DmaDevice::DmaDevice(const Params *p)
-    : PioDevice(p), dmaPort(this, sys, p->sid, p->ssid)
+    : PioDevice(p), dmaPort(this, sys, p->sid, p->ssid, p->coalesce_dma)
 { }
 
 void
@@ -134,7 +155,7 @@ DmaDevice::init()
 DrainState
 DmaPort::drain()
 {
-    if (pendingCount == 0) {
+    if (pendingCount == 0 && transmitList.empty()) {
         return DrainState::Drained;
     } else {
         DPRINTF(Drain, "DmaPort not drained\n");
@@ -149,86 +170,55 @@ DmaPort::recvReqRetry()
     trySendTimingReq();
 }
 
-RequestPtr
+void
 DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    uint8_t *data, uint32_t sid, uint32_t ssid, Tick delay,
                    Request::Flags flag)
 {
     // one DMA request sender state for every action, that is then
     // split into many requests and packets based on the block size,
-    // i.e. cache line size
-    DmaReqState *reqState = new DmaReqState(event, size, delay);
-
-    // (functionality added for Table Walker statistics)
-    // We're only interested in this when there will only be one request.
-    // For simplicity, we return the last request, which would also be
-    // the only request in that case.
-    RequestPtr req = NULL;
+    // i.e. cache line size, as they are sent
+    DmaReqState *reqState = new DmaReqState(
+        cmd, addr, sys->cacheLineSize(), size, data, flag, masterId,
+        sid, ssid, event, delay);
 
     DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d\n", addr, size,
             event ? event->scheduled() : -1);
-    for (ChunkGenerator gen(addr, size, sys->cacheLineSize());
-         !gen.done(); gen.next()) {
-
-        req = std::make_shared<Request>(
-            gen.addr(), gen.size(), flag, masterId);
-
-        req->setStreamId(sid);
-        req->setSubStreamId(ssid);
-
-        req->taskId(ContextSwitchTaskId::DMA);
-        PacketPtr pkt = new Packet(req, cmd);
+    transmitList.push_back(reqState);
 
-        // Increment the data pointer on a write
-        if (data)
-            pkt->dataStatic(data + gen.complete());
-
-        pkt->senderState = reqState;
-
-        DPRINTF(DMA, "--Queuing DMA for addr: %#x size: %d\n", gen.addr(),
-                gen.size());
-        queueDma(pkt);
-    }
-
-    // in zero time also initiate the sending of the packets we have
-    // just created, for atomic this involves actually completing all
-    // the requests
+    // in zero time also initiate the sending of the packets, for
+    // atomic this involves actually completing all the requests
     sendDma();
-
-    return req;
 }
 
-RequestPtr
+void
 DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    uint8_t *data, Tick delay, Request::Flags flag)
 {
-    return dmaAction(cmd, addr, size, event, data,
-                     defaultSid, defaultSSid, delay, flag);
-}
-
-void
-DmaPort::queueDma(PacketPtr pkt)
-{
-    transmitList.push_back(pkt);
-
-    // remember that we have another packet pending, this will only be
-    // decremented once a response comes back
-    pendingCount++;
+    dmaAction(cmd, addr, size, event, data,
+              defaultSid, defaultSSid, delay, flag);
 }
 
 void
 DmaPort::trySendTimingReq()
 {
-    // send the first packet on the transmit list and schedule the
-    // following send if it is successful
-    PacketPtr pkt = transmitList.front();
+    // send the next chunk of the first transfer on the transmit list
+    // and schedule the following send if it is successful
+    DmaReqState *state = transmitList.front();
+    PacketPtr pkt = state->createPacket();
 
     DPRINTF(DMA, "Trying to send %s addr %#x\n", pkt->cmdString(),
             pkt->getAddr());
 
+    // remember that we have another packet pending, this will only be
+    // decremented once a response comes back
+    pendingCount++;
+
     inRetry = !sendTimingReq(pkt);
     if (!inRetry) {
-        transmitList.pop_front();
+        state->gen.next();
+        if (state->gen.done())
+            transmitList.pop_front();
         DPRINTF(DMA, "-- Done\n");
         // if there is more to do, then do so
         if (!transmitList.empty())
@@ -238,6 +228,9 @@ DmaPort::trySendTimingReq()
             // cycle
             device->schedule(sendEvent, device->clockEdge(Cycles(1)));
     } else {
+        // the packet for the chunk is created again on the retry
+        pendingCount--;
+        delete pkt;
         DPRINTF(DMA, "-- Failed, waiting for retry\n");
     }
 
@@ -263,21 +256,68 @@ DmaPort::sendDma()
 
         trySendTimingReq();
     } else if (sys->isAtomicMode()) {
+        // without caches, memory is always up to date and can be read
+        // directly. Writes always go through the memory, which clears
+        // LL/SC reservations and counts them in its stats.
+        const bool backdoor = coalesce && sys->bypassCaches();
+
         // send everything there is to send in zero time
         while (!transmitList.empty()) {
-            PacketPtr pkt = transmitList.front();
+            DmaReqState *state = transmitList.front();
             transmitList.pop_front();
 
-            DPRINTF(DMA, "Sending  DMA for addr: %#x size: %d\n",
-                    pkt->req->getPaddr(), pkt->req->getSize());
-            Tick lat = sendAtomic(pkt);
-
-            handleResp(pkt, lat);
+            // the state is deleted with the response to the last chunk
+            bool done = false;
+            while (!done) {
+                PacketPtr pkt = state->createPacket();
+                state->gen.next();
+                done = state->gen.done();
+                pendingCount++;
+
+                DPRINTF(DMA, "Sending  DMA for addr: %#x size: %d\n",
+                        pkt->req->getPaddr(), pkt->req->getSize());
+                Tick lat;
+                if (backdoor && !done && state->cmd.isRead()) {
+                    MemBackdoorPtr bd = nullptr;
+                    lat = sendAtomicBackdoor(pkt, bd);
+                    if (bd)
+                        done = accessBackdoor(state, *bd);
+                } else {
+                    lat = sendAtomic(pkt);
+                }
+
+                handleResp(pkt, lat);
+            }
         }
     } else
         panic("Unknown memory mode.");
 }
 
+bool
+DmaPort::accessBackdoor(DmaReqState *state, const MemBackdoor &backdoor)
+{
+    const Addr addr = state->gen.addr();
+    const Addr size = state->totBytes - state->gen.complete();
+    const AddrRange &range = backdoor.range();
+
+    if (!state->data || !range.contains(addr) ||
+        !range.contains(addr + size - 1)) {
+        return false;
+    }
+
+    assert(state->cmd.isRead());
+    if (!backdoor.readable())
+        return false;
+
+    const uint8_t *host = backdoor.ptr() + (addr - range.start());
+    std::memcpy(state->data + state->gen.complete(), host, size);
+
+    DPRINTF(DMA, "Completed DMA for addr: %#x size: %d through back door\n",
+            addr, size);
+    state->numBytes += size;
+    return true;
+}
+
 Port &
 DmaDevice::getPort(const std::string &if_name, PortID idx)
 {
@@ -48,8 +48,10 @@
 #include <deque>
 #include <memory>
 
+#include "base/chunk_generator.hh"
 #include "base/circlebuf.hh"
 #include "dev/io_device.hh"
+#include "mem/backdoor.hh"
 #include "params/DmaDevice.hh"
 #include "sim/drain.hh"
 #include "sim/system.hh"
@@ -61,19 +63,19 @@ class DmaPort : public MasterPort, public Drainable
   private:
 
     /**
-     * Take the first packet of the transmit list and attempt to send
-     * it as a timing request. If it is successful, schedule the
-     * sending of the next packet, otherwise remember that we are
-     * waiting for a retry.
+     * Create a packet for the next chunk of the first transfer on
+     * the transmit list and attempt to send it as a timing request.
+     * If it is successful, schedule the sending of the next packet,
+     * otherwise remember that we are waiting for a retry.
      */
     void trySendTimingReq();
 
     /**
-     * For timing, attempt to send the first item on the transmit
-     * list, and if it is successful and there are more packets
-     * waiting, then schedule the sending of the next packet. For
-     * atomic, simply send and process everything on the transmit
-     * list.
+     * For timing, attempt to send the next chunk of the first
+     * transfer on the transmit list, and if it is successful and
+     * there are more chunks waiting, then schedule the sending of the
+     * next packet. For atomic, simply send and process everything on
+     * the transmit list.
      */
     void sendDma();
 
@@ -89,6 +91,11 @@ class DmaPort : public MasterPort, public Drainable
      */
     void handleResp(PacketPtr pkt, Tick delay = 0);
 
+    /**
+     * State of a DMA transfer. Packets are only created for a chunk
+     * of the transfer when it is sent, so a transfer of any size only
+     * takes one of these on the transmit list.
+     */
     struct DmaReqState : public Packet::SenderState
     {
         /** Event to call on the device when this transaction (all packets)
@@ -104,11 +111,42 @@ class DmaPort : public MasterPort, public Drainable
         /** Amount to delay completion of dma by */
         const Tick delay;
 
-        DmaReqState(Event *ce, Addr tb, Tick _delay)
-            : completionEvent(ce), totBytes(tb), numBytes(0), delay(_delay)
+        /** Chunk of the transfer to send next. */
+        ChunkGenerator gen;
+
+        /** Command, data buffer and request attributes of the transfer. */
+        const MemCmd cmd;
+        uint8_t *const data;
+        const Request::Flags flags;
+        const MasterID masterId;
+        const uint32_t sid;
+        const uint32_t ssid;
+
+        DmaReqState(Packet::Command _cmd, Addr addr, Addr chunk_size,
+                    Addr tb, uint8_t *_data, Request::Flags _flags,
+                    MasterID master_id, uint32_t _sid, uint32_t _ssid,
+                    Event *ce, Tick _delay)
+            : completionEvent(ce), totBytes(tb), numBytes(0), delay(_delay),
+              gen(addr, tb, chunk_size), cmd(_cmd), data(_data),
+              flags(_flags), masterId(master_id), sid(_sid), ssid(_ssid)
         {}
+
+        /** Create a packet for the current chunk of the transfer. */
+        PacketPtr createPacket();
     };
 
+    /**
+     * Copy the rest of an atomic read transfer, i.e. everything after
+     * the current chunk, through a back door to memory.
+     *
+     * @param state Read transfer to complete.
+     * @param backdoor Back door returned by the access of the current
+     * chunk.
+     * @return true if the back door covers the rest of the transfer
+     * and the data has been copied.
+     */
+    bool accessBackdoor(DmaReqState *state, const MemBackdoor &backdoor);
+
   public:
     /** The device that owns this port. */
     ClockedObject *const device;
@@ -121,8 +159,11 @@ class DmaPort : public MasterPort, public Drainable
     const MasterID masterId;
 
   protected:
-    /** Use a deque as we never do any insertion or removal in the middle */
-    std::deque<PacketPtr> transmitList;
+    /**
+     * Transfers with chunks left to send. Use a deque as we never do
+     * any insertion or removal in the middle.
+     */
+    std::deque<DmaReqState *> transmitList;
 
     /** Event used to schedule a future sending from the transmit list. */
     EventFunctionWrapper sendEvent;
@@ -140,28 +181,44 @@ class DmaPort : public MasterPort, public Drainable
     /** Default substreamId */
     const uint32_t defaultSSid;
 
+    /**
+     * Complete atomic transfers through a back door to memory after
+     * their first chunk if the system bypasses caches.
+     */
+    const bool coalesce;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt) override;
     void recvReqRetry() override;
 
-    void queueDma(PacketPtr pkt);
-
   public:
 
+    /**
+     * @param coalesce In atomic mode, when the system bypasses caches,
+     * only send the first chunk of a read transfer as a packet and
+     * copy the rest through the back door the memory returns for it,
+     * if any. Only the first chunk is then seen by the memory system,
+     * e.g., in its stats. Writes are always sent as packets, since
+     * they have to clear LL/SC reservations in the memory.
+     */
     DmaPort(ClockedObject *dev, System *s,
-            uint32_t sid = 0, uint32_t ssid = 0);
+            uint32_t sid = 0, uint32_t ssid = 0, bool coalesce = false);
 
-    RequestPtr
+    void
     dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
               uint8_t *data, Tick delay, Request::Flags flag = 0);
 
-    RequestPtr
+    void
     dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
               uint8_t *data, uint32_t sid, uint32_t ssid, Tick delay,
               Request::Flags flag = 0);
 
-    bool dmaPending() const { return pendingCount > 0; }
+    bool
+    dmaPending() const
+    {
+        return pendingCount > 0 || !transmitList.empty();
+    }
 
     DrainState drain() override;
 };
@@ -65,6 +65,10 @@ class EtherLink(SimObject):
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
+# Transport used by the processes of a dist run to talk to each other:
+# TCP sockets, or shared memory if they all run on the same host.
+class DistTransport(Enum): vals = ['tcp', 'shm']
+
 class DistEtherLink(SimObject):
     type = 'DistEtherLink'
     cxx_header = "dev/net/dist_etherlink.hh"
@@ -79,8 +83,11 @@ class DistEtherLink(SimObject):
     sync_repeat = Param.Latency('10us', "dist sync barrier repeat")
     server_name = Param.String('localhost', "Message server name")
     server_port = Param.UInt32('2200', "Message server port")
+    transport = Param.DistTransport('tcp', "Dist message transport")
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
     dist_sync_on_pseudo_op = Param.Bool(False, "Start sync with pseudo_op")
+    dist_sync_adaptive = Param.Bool(False, "Skip sync quanta in which no "
+        "packet can be sent (all gem5 processes must enable it)")
     num_nodes = Param.UInt32('2', "Number of simulate nodes")
 
 class EtherBus(SimObject):
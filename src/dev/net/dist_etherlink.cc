@@ -62,6 +62,7 @@
 #include "dev/net/etherint.hh"
 #include "dev/net/etherlink.hh"
 #include "dev/net/etherpkt.hh"
+#include "dev/net/shm_iface.hh"
 #include "dev/net/tcp_iface.hh"
 #include "params/EtherLink.hh"
 #include "sim/core.hh"
@@ -90,12 +91,22 @@ DistEtherLink::DistEtherLink(const Params *p)
         sync_repeat = p->delay;
     }
 
-    // create the dist (TCP) interface to talk to the peer gem5 processes.
-    distIface = new TCPIface(p->server_name, p->server_port,
-                             p->dist_rank, p->dist_size,
-                             p->sync_start, sync_repeat, this,
-                             p->dist_sync_on_pseudo_op, p->is_switch,
-                             p->num_nodes);
+    // create the dist interface to talk to the peer gem5 processes.
+    if (p->transport == Enums::shm) {
+        distIface = new ShmIface(p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op,
+                                 p->dist_sync_adaptive, p->is_switch,
+                                 p->num_nodes);
+    } else {
+        distIface = new TCPIface(p->server_name, p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op,
+                                 p->dist_sync_adaptive, p->is_switch,
+                                 p->num_nodes);
+    }
 
     localIface = new LocalIface(name() + ".int0", txLink, rxLink, distIface);
 }
@@ -186,7 +197,7 @@ DistEtherLink::TxLink::txDone()
 }
 
 bool
-DistEtherLink::TxLink::transmit(EthPacketPtr pkt)
+DistEtherLink::TxLink::transmit(const EthPacketPtr &pkt)
 {
     if (busy()) {
         DPRINTF(DistEthernet, "packet not sent, link busy\n");
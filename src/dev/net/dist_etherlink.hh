@@ -138,7 +138,7 @@ class DistEtherLink : public SimObject
          *
          * @param packet Ethernet packet to send
          */
-        bool transmit(EthPacketPtr packet);
+        bool transmit(const EthPacketPtr &packet);
     };
 
     /**
@@ -189,7 +189,11 @@ class DistEtherLink : public SimObject
         LocalIface(const std::string &name, TxLink *tx, RxLink *rx,
                    DistIface *m);
 
-        bool recvPacket(EthPacketPtr pkt) { return txLink->transmit(pkt); }
+        bool
+        recvPacket(const EthPacketPtr &pkt)
+        {
+            return txLink->transmit(pkt);
+        }
         void sendDone() { peer->sendDone(); }
         bool isBusy() { return txLink->busy(); }
     };
@@ -43,6 +43,7 @@
 
 #include "dev/net/dist_iface.hh"
 
+#include <algorithm>
 #include <queue>
 #include <thread>
 
@@ -93,10 +94,56 @@ DistIface::Sync::abort()
     cv.notify_one();
 }
 
-DistIface::SyncSwitch::SyncSwitch(int num_nodes)
+Tick
+DistIface::Sync::localNextSend()
+{
+    // Without a bound, a packet may be sent right after the sync.
+    Tick next_send = curTick() + 1;
+    // Events are also scheduled across event queues in parallel runs,
+    // so the queue heads don't give a bound there.
+    if (!adaptive || numMainEventQueues > 1)
+        return next_send;
+
+    // The simulation thread is waiting in the sync but the receiver
+    // threads may be scheduling receive events.
+    EventQueue *eventq = mainEventQueue[0];
+    eventq->lock();
+    next_send = eventq->empty() ? MaxTick : eventq->nextTick();
+    eventq->unlock();
+
+    next_send = std::min(next_send, inFlight);
+    inFlight = MaxTick;
+    return next_send;
+}
+
+Tick
+DistIface::Sync::nextSyncTick() const
+{
+    // A packet sent at or after nextSendAt arrives at nextSendAt +
+    // nextRepeat at the earliest (nextRepeat may not be greater than
+    // any of the link delays), i.e. after the next sync.
+    const Tick start =
+        nextSendAt > curTick() + 1 ? nextSendAt - 1 : curTick();
+    if (start > MaxTick - nextRepeat)
+        return MaxTick;
+    return start + nextRepeat;
+}
+
+void
+DistIface::Sync::packetSent(Tick send_done)
+{
+    if (!adaptive)
+        return;
+    std::lock_guard<std::mutex> sync_lock(lock);
+    inFlight = std::min(inFlight, send_done + nextRepeat);
+}
+
+DistIface::SyncSwitch::SyncSwitch(int num_nodes, bool adaptive_sync) :
+    Sync(adaptive_sync)
 {
     numNodes = num_nodes;
     waitNum = num_nodes;
+    nextSend = MaxTick;
     numExitReq = 0;
     numCkptReq = 0;
     numStopSyncReq = 0;
@@ -108,7 +155,7 @@ DistIface::SyncSwitch::SyncSwitch(int num_nodes)
     isAbort = false;
 }
 
-DistIface::SyncNode::SyncNode()
+DistIface::SyncNode::SyncNode(bool adaptive_sync) : Sync(adaptive_sync)
 {
     waitNum = 0;
     needExit = ReqType::none;
@@ -135,6 +182,9 @@ DistIface::SyncNode::run(bool same_tick)
     header.msgType = MsgType::cmdSyncReq;
     header.sendTick = curTick();
     header.syncRepeat = nextRepeat;
+    // Only the periodic sync adapts the quantum, the others may run with
+    // the event queue locked.
+    header.nextSendTick = same_tick ? localNextSend() : curTick() + 1;
     header.needCkpt = needCkpt;
     header.needStopSync = needStopSync;
     if (needCkpt != ReqType::none)
@@ -173,6 +223,10 @@ DistIface::SyncSwitch::run(bool same_tick)
     header.msgType = MsgType::cmdSyncAck;
     header.sendTick = nextAt;
     header.syncRepeat = nextRepeat;
+    nextSendAt = std::min(nextSend,
+                          same_tick ? localNextSend() : curTick() + 1);
+    nextSend = MaxTick;
+    header.nextSendTick = nextSendAt;
     if (doCkpt || numCkptReq == numNodes) {
         doCkpt = true;
         header.needCkpt = ReqType::immediate;
@@ -200,6 +254,7 @@ DistIface::SyncSwitch::run(bool same_tick)
 bool
 DistIface::SyncSwitch::progress(Tick send_tick,
                                  Tick sync_repeat,
+                                 Tick next_send,
                                  ReqType need_ckpt,
                                  ReqType need_exit,
                                  ReqType need_stop_sync)
@@ -213,6 +268,8 @@ DistIface::SyncSwitch::progress(Tick send_tick,
         nextAt = send_tick;
     if (nextRepeat > sync_repeat)
         nextRepeat = sync_repeat;
+    if (nextSend > next_send)
+        nextSend = next_send;
 
     if (need_ckpt == ReqType::collective)
         numCkptReq++;
@@ -241,6 +298,7 @@ DistIface::SyncSwitch::progress(Tick send_tick,
 bool
 DistIface::SyncNode::progress(Tick max_send_tick,
                                Tick next_repeat,
+                               Tick next_send,
                                ReqType do_ckpt,
                                ReqType do_exit,
                                ReqType do_stop_sync)
@@ -252,6 +310,7 @@ DistIface::SyncNode::progress(Tick max_send_tick,
 
     nextAt = max_send_tick;
     nextRepeat = next_repeat;
+    nextSendAt = next_send;
     doCkpt = (do_ckpt != ReqType::none);
     doExit = (do_exit != ReqType::none);
     doStopSync = (do_stop_sync != ReqType::none);
@@ -424,9 +483,11 @@ DistIface::SyncEvent::process()
         }
         return;
     }
-    // schedule the next periodic sync
-    repeat = DistIface::sync->nextRepeat;
-    schedule(curTick() + repeat);
+    // schedule the next periodic sync, repeat always holds the length of
+    // the current quantum
+    const Tick next = DistIface::sync->nextSyncTick();
+    repeat = next - curTick();
+    schedule(next);
 }
 
 void
@@ -609,6 +670,7 @@ DistIface::DistIface(unsigned dist_rank,
                      Tick sync_repeat,
                      EventManager *em,
                      bool use_pseudo_op,
+                     bool adaptive_sync,
                      bool is_switch, int num_nodes) :
     syncStart(sync_start), syncRepeat(sync_repeat),
     recvThread(nullptr), recvScheduler(em), syncStartOnPseudoOp(use_pseudo_op),
@@ -621,9 +683,9 @@ DistIface::DistIface(unsigned dist_rank,
         assert(syncEvent == nullptr);
         isSwitch = is_switch;
         if (is_switch)
-            sync = new SyncSwitch(num_nodes);
+            sync = new SyncSwitch(num_nodes, adaptive_sync);
         else
-            sync = new SyncNode();
+            sync = new SyncNode(adaptive_sync);
         syncEvent = new SyncEvent();
         master = this;
         isMaster = true;
@@ -648,7 +710,7 @@ DistIface::~DistIface()
 }
 
 void
-DistIface::packetOut(EthPacketPtr pkt, Tick send_delay)
+DistIface::packetOut(const EthPacketPtr &pkt, Tick send_delay)
 {
     Header header;
 
@@ -663,6 +725,7 @@ DistIface::packetOut(EthPacketPtr pkt, Tick send_delay)
 
     // Send out the packet and the meta info.
     sendPacket(header, pkt);
+    sync->packetSent(header.sendTick + send_delay);
 
     DPRINTF(DistEthernetPkt,
             "DistIface::sendDataPacket() done size:%d send_delay:%llu\n",
@@ -706,6 +769,7 @@ DistIface::recvThreadFunc(Event *recv_done, Tick link_delay)
             // everything else must be synchronisation related command
             if (!sync->progress(header.sendTick,
                                 header.syncRepeat,
+                                header.nextSendTick,
                                 header.needCkpt,
                                 header.needExit,
                                 header.needStopSync))
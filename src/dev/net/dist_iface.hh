@@ -72,7 +72,9 @@
  *
  * This interface is an abstract class. It can work with various low level
  * send/receive service implementations (e.g. TCP/IP, MPI,...). A TCP
- * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc].
+ * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc],
+ * a shared memory version for runs on a single host is implemented in
+ * src/dev/net/shm_iface.[hh,cc].
  */
 #ifndef __DEV_DIST_IFACE_HH__
 #define __DEV_DIST_IFACE_HH__
@@ -157,10 +159,39 @@ class DistIface : public Drainable, public Serializable
          *  Flag is set if the sync is aborted (e.g. due to connection lost)
          */
         bool isAbort;
+        /**
+         * Flag is set if the quantum is adapted to the traffic (see
+         * nextSyncTick())
+         */
+        const bool adaptive;
+        /**
+         * Earliest tick any gem5 process may send a data packet at, as
+         * agreed on by the last completed sync
+         */
+        Tick nextSendAt;
+        /**
+         * Earliest arrival tick of the data packets this process sent
+         * since the last sync
+         */
+        Tick inFlight;
 
         friend class SyncEvent;
 
+        /**
+         * Lower bound on the tick this process sends its next data
+         * packet at. Nothing can happen in this process before its next
+         * scheduled event or before a packet it has sent arrives at a
+         * peer (which may then respond to it). The bound is only
+         * computed in adaptive mode.
+         *
+         * @note The sync lock must be held and the event queue lock must
+         * not be.
+         */
+        Tick localNextSend();
+
       public:
+        Sync(bool adaptive_sync) : adaptive(adaptive_sync),
+            nextSendAt(0), inFlight(MaxTick) {}
         /**
          * Initialize periodic sync params.
          *
@@ -183,6 +214,7 @@ class DistIface : public Drainable, public Serializable
          */
         virtual bool progress(Tick send_tick,
                               Tick next_repeat,
+                              Tick next_send,
                               ReqType do_ckpt,
                               ReqType do_exit,
                               ReqType do_stop_sync) = 0;
@@ -191,6 +223,21 @@ class DistIface : public Drainable, public Serializable
          * lost connection to a peer gem5)
          */
         void abort();
+        /**
+         * Tick of the next periodic sync. The fixed mode simply adds the
+         * repeat value to the current tick. In adaptive mode the quantum
+         * starts at the earliest tick any gem5 process may send a packet
+         * at instead, so quanta where nothing can be sent are skipped.
+         * Every process gets the same result since the earliest send
+         * tick comes from the switch.
+         */
+        Tick nextSyncTick() const;
+        /**
+         * Record the send of a data packet for the adaptive sync.
+         *
+         * @param send_done Tick the packet is completely sent out at.
+         */
+        void packetSent(Tick send_done);
 
         virtual void requestCkpt(ReqType req) = 0;
         virtual void requestExit(ReqType req) = 0;
@@ -220,11 +267,12 @@ class DistIface : public Drainable, public Serializable
 
       public:
 
-        SyncNode();
+        SyncNode(bool adaptive_sync);
         ~SyncNode() {}
         bool run(bool same_tick) override;
         bool progress(Tick max_req_tick,
                       Tick next_repeat,
+                      Tick next_send,
                       ReqType do_ckpt,
                       ReqType do_exit,
                       ReqType do_stop_sync) override;
@@ -256,14 +304,19 @@ class DistIface : public Drainable, public Serializable
          *  Number of connected simulated nodes
          */
         unsigned numNodes;
+        /**
+         * Minimum of the next send ticks received in the current sync
+         */
+        Tick nextSend;
 
       public:
-        SyncSwitch(int num_nodes);
+        SyncSwitch(int num_nodes, bool adaptive_sync);
         ~SyncSwitch() {}
 
         bool run(bool same_tick) override;
         bool progress(Tick max_req_tick,
                       Tick next_repeat,
+                      Tick next_send,
                       ReqType do_ckpt,
                       ReqType do_exit,
                       ReqType do_stop_sync) override;
@@ -293,6 +346,9 @@ class DistIface : public Drainable, public Serializable
      * for each simulated Ethernet link.
      * 3. Simulation thread(s) then waits until all receiver threads
      * complete the ongoing barrier. The global sync event is done.
+     * 4. The next sync is scheduled one quantum later, or later still in
+     * adaptive mode if no process can send a packet before then (see
+     * Sync::nextSyncTick()).
      */
     class SyncEvent : public GlobalSyncEvent
     {
@@ -572,6 +628,7 @@ class DistIface : public Drainable, public Serializable
      * @param sync_start Start tick for dist synchronisation
      * @param sync_repeat Frequency for dist synchronisation
      * @param em The event manager associated with the simulated Ethernet link
+     * @param adaptive_sync Skip sync quanta in which no packet can be sent
      */
     DistIface(unsigned dist_rank,
               unsigned dist_size,
@@ -579,6 +636,7 @@ class DistIface : public Drainable, public Serializable
               Tick sync_repeat,
               EventManager *em,
               bool use_pseudo_op,
+              bool adaptive_sync,
               bool is_switch,
               int num_nodes);
 
@@ -588,7 +646,7 @@ class DistIface : public Drainable, public Serializable
      * @param pkt The Ethernet packet to send.
      * @param send_delay The delay in ticks for the send completion event.
      */
-    void packetOut(EthPacketPtr pkt, Tick send_delay);
+    void packetOut(const EthPacketPtr &pkt, Tick send_delay);
     /**
      * Fetch the packet scheduled to be received next by the simulated
      * network link.
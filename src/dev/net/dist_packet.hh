@@ -95,6 +95,11 @@ class DistHeaderPkt
             Tick sendDelay;
             Tick syncRepeat;
         };
+        /**
+         * Earliest tick the sender of a sync message may send its next
+         * data packet at (used by the adaptive sync).
+         */
+        Tick nextSendTick;
         union {
             /**
              * Actual length of the simulated Ethernet packet.
@@ -176,7 +176,7 @@ EtherLink::Link::processTxQueue()
 }
 
 bool
-EtherLink::Link::transmit(EthPacketPtr pkt)
+EtherLink::Link::transmit(const EthPacketPtr &pkt)
 {
     if (busy()) {
         DPRINTF(Ethernet, "packet not sent, link busy\n");
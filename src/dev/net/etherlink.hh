@@ -113,7 +113,7 @@ class EtherLink : public SimObject
         const std::string name() const { return objName; }
 
         bool busy() const { return (bool)packet; }
-        bool transmit(EthPacketPtr packet);
+        bool transmit(const EthPacketPtr &packet);
 
         void setTxInt(Interface *i) { assert(!txint); txint = i; }
         void setRxInt(Interface *i) { assert(!rxint); rxint = i; }
@@ -132,7 +132,11 @@ class EtherLink : public SimObject
 
       public:
         Interface(const std::string &name, Link *txlink, Link *rxlink);
-        bool recvPacket(EthPacketPtr packet) { return txlink->transmit(packet); }
+        bool
+        recvPacket(const EthPacketPtr &packet)
+        {
+            return txlink->transmit(packet);
+        }
         void sendDone() { peer->sendDone(); }
         bool isBusy() { return txlink->busy(); }
     };
@@ -31,13 +31,92 @@
 #include "dev/net/etherpkt.hh"
 
 #include <iostream>
+#include <vector>
 
 #include "base/inet.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "sim/serialize.hh"
 
 using namespace std;
 
+namespace
+{
+
+/** Buffers of sizes in [MinPooled, MaxPooled] are pooled. */
+const unsigned MinPooled = 1 << 11;
+const unsigned MaxPooled = 1 << 16;
+/** Number of free buffers kept per size class. */
+const size_t MaxFree = 256;
+
+/**
+ * Free buffers, indexed by size class: buffers in class i are
+ * MinPooled << i bytes. Packets can be freed by a different thread than
+ * the one that allocated them, so each thread has its own pool.
+ */
+struct BufferPool
+{
+    static const unsigned NumClasses = 6;
+    std::vector<uint8_t *> free[NumClasses];
+
+    /** Size class of a buffer, NumClasses if it isn't pooled. */
+    static unsigned
+    sizeClass(unsigned size)
+    {
+        if (size < MinPooled || size > MaxPooled)
+            return NumClasses;
+        return ceilLog2(size) - floorLog2(MinPooled);
+    }
+};
+
+/**
+ * The pool of the current thread. It's never deleted since packets
+ * may outlive thread local storage at exit.
+ */
+thread_local BufferPool *bufferPool = nullptr;
+
+BufferPool &
+threadPool()
+{
+    if (!bufferPool)
+        bufferPool = new BufferPool;
+    return *bufferPool;
+}
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocBuffer(unsigned size)
+{
+    const unsigned cls = BufferPool::sizeClass(size);
+    if (cls == BufferPool::NumClasses)
+        return new uint8_t[size];
+
+    std::vector<uint8_t *> &free_list = threadPool().free[cls];
+    if (free_list.empty())
+        return new uint8_t[MinPooled << cls];
+
+    uint8_t *buf = free_list.back();
+    free_list.pop_back();
+    return buf;
+}
+
+void
+EthPacketData::freeBuffer(uint8_t *buf, unsigned size)
+{
+    const unsigned cls = BufferPool::sizeClass(size);
+    if (cls == BufferPool::NumClasses) {
+        delete [] buf;
+        return;
+    }
+
+    std::vector<uint8_t *> &free_list = threadPool().free[cls];
+    if (free_list.size() < MaxFree)
+        free_list.push_back(buf);
+    else
+        delete [] buf;
+}
+
 void
 EthPacketData::serialize(const string &base, CheckpointOut &cp) const
 {
@@ -65,8 +144,10 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
             bufLength = length;
     }
     assert(length <= bufLength);
-    if (!data)
-        data = new uint8_t[bufLength];
+    if (!data) {
+        data = allocBuffer(bufLength);
+        allocLength = bufLength;
+    }
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
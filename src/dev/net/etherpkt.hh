@@ -45,6 +45,12 @@
 
 /*
  * Reference counted class containing ethernet packet data
+ *
+ * Packets are passed by reference between devices, links and
+ * switches, so every receiver of a packet shares the same data.
+ * Receivers must not modify it. Data buffers come from a per-thread
+ * pool of recycled buffers since devices usually allocate a full
+ * sized buffer for every packet they transmit.
  */
 class EthPacketData
 {
@@ -74,17 +80,30 @@ class EthPacketData
     unsigned simLength;
 
     EthPacketData()
-        : data(nullptr), bufLength(0), length(0), simLength(0)
+        : data(nullptr), bufLength(0), length(0), simLength(0), allocLength(0)
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
+        : data(allocBuffer(size)), bufLength(size), length(0), simLength(0),
+          allocLength(size)
     { }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData() { if (data) freeBuffer(data, allocLength); }
+
+    EthPacketData(const EthPacketData &other) = delete;
+    EthPacketData &operator=(const EthPacketData &other) = delete;
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    /** Size the data buffer was allocated with. */
+    unsigned allocLength;
+
+    /** Get a buffer of size bytes, from the pool if possible. */
+    static uint8_t *allocBuffer(unsigned size);
+    /** Return a buffer of size bytes to the pool. */
+    static void freeBuffer(uint8_t *buf, unsigned size);
 };
 
 typedef std::shared_ptr<EthPacketData> EthPacketPtr;
@@ -74,7 +74,8 @@ EtherSwitch::getPort(const std::string &if_name, PortID idx)
 }
 
 bool
-EtherSwitch::Interface::PortFifo::push(EthPacketPtr ptr, unsigned senderId)
+EtherSwitch::Interface::PortFifo::push(const EthPacketPtr &ptr,
+                                        unsigned senderId)
 {
     assert(ptr->length);
 
@@ -136,7 +137,7 @@ EtherSwitch::Interface::Interface(const std::string &name,
 }
 
 bool
-EtherSwitch::Interface::recvPacket(EthPacketPtr packet)
+EtherSwitch::Interface::recvPacket(const EthPacketPtr &packet)
 {
     Net::EthAddr destMacAddr(packet->data);
     Net::EthAddr srcMacAddr(&packet->data[6]);
@@ -163,7 +164,8 @@ EtherSwitch::Interface::recvPacket(EthPacketPtr packet)
 }
 
 void
-EtherSwitch::Interface::enqueue(EthPacketPtr packet, unsigned senderId)
+EtherSwitch::Interface::enqueue(const EthPacketPtr &packet,
+                                unsigned senderId)
 {
     // assuming per-interface transmission events,
     // if the newly push packet gets inserted at the head of the queue
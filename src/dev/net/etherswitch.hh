@@ -78,11 +78,11 @@ class EtherSwitch : public SimObject
          * When a packet is received from a device, route it
          * through an (several) output queue(s)
          */
-        bool recvPacket(EthPacketPtr packet);
+        bool recvPacket(const EthPacketPtr &packet);
         /**
          * enqueue packet to the outputFifo
          */
-        void enqueue(EthPacketPtr packet, unsigned senderId);
+        void enqueue(const EthPacketPtr &packet, unsigned senderId);
         void sendDone() {}
         Tick switchingDelay();
 
@@ -159,7 +159,7 @@ class EtherSwitch : public SimObject
              * Push a packet into the fifo
              * and sort the packets with same recv tick by port id
              */
-            bool push(EthPacketPtr ptr, unsigned senderId);
+            bool push(const EthPacketPtr &ptr, unsigned senderId);
             void pop();
             void clear();
             /**
@@ -103,7 +103,7 @@ class EtherTapBase : public SimObject
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
 
-    bool recvSimulated(EthPacketPtr packet);
+    bool recvSimulated(const EthPacketPtr &packet);
     void sendSimulated(void *data, size_t len);
 
   protected:
@@ -121,7 +121,7 @@ class EtherTapInt : public EtherInt
             EtherInt(name), tap(t)
     { }
 
-    bool recvPacket(EthPacketPtr pkt) override
+    bool recvPacket(const EthPacketPtr &pkt) override
         { return tap->recvSimulated(pkt); }
     void sendDone() override {}
 };
@@ -2232,7 +2232,7 @@ IGbE::txStateMachine()
 }
 
 bool
-IGbE::ethRxPkt(EthPacketPtr pkt)
+IGbE::ethRxPkt(const EthPacketPtr &pkt)
 {
     rxBytes += pkt->length;
     rxPackets++;
@@ -0,0 +1,468 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* @file
+ * Shared memory based interface class implementation for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_iface.hh"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+#include "base/compiler.hh"
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/types.hh"
+#include "debug/DistEthernet.hh"
+#include "debug/DistEthernetCmd.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "Shared memory rings need lock-free atomics");
+
+namespace
+{
+
+/** Size of the data buffer of a ring, must be a power of two. */
+const uint32_t RingSize = 1 << 20;
+/** Number of polls of a ring before the receiver goes to sleep. */
+const unsigned SpinCount = 1 << 12;
+
+const uint32_t ChannelMagic = 0x67356473;
+
+enum ChannelState : uint32_t
+{
+    /** Created by the compute node, not initialized yet. */
+    Created = 0,
+    /** Compute node link info is valid, waiting for the switch. */
+    NodeReady,
+    /** The switch has opened the link. */
+    Connected,
+};
+
+/**
+ * Sleep until word may have changed from val. The sleep times out
+ * regularly so that callers can check whether their peer is still
+ * alive.
+ *
+ * @return false if the sleep timed out.
+ */
+bool
+waitWord(std::atomic<uint32_t> &word, uint32_t val)
+{
+#if defined(__linux__)
+    struct timespec timeout = { 0, 100 * 1000 * 1000 };
+    const long ret = syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAIT, val,
+                             &timeout, nullptr, 0);
+    return ret == 0 || errno != ETIMEDOUT;
+#else
+    struct timespec delay = { 0, 50 * 1000 };
+    nanosleep(&delay, nullptr);
+    return word.load() != val;
+#endif
+}
+
+/** Wake up all the processes sleeping on word. */
+void
+wakeWord(std::atomic<uint32_t> &word)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+#endif
+}
+
+bool
+processAlive(int32_t pid)
+{
+    return pid == 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/**
+ * Wait until a ring index changes from val. The caller is flagged as
+ * waiting before it goes to sleep, so that the other end only needs to
+ * make a system call to wake it up if it actually sleeps.
+ *
+ * @return false if the peer process has died.
+ */
+bool
+waitIndex(std::atomic<uint32_t> &index, uint32_t val,
+          std::atomic<uint32_t> &waiting, int32_t peer)
+{
+    for (unsigned i = 0; i < SpinCount; ++i) {
+        if (index.load(std::memory_order_acquire) != val)
+            return true;
+    }
+
+    bool alive = true;
+    waiting.store(1);
+    if (index.load() == val && !waitWord(index, val))
+        alive = processAlive(peer);
+    waiting.store(0, std::memory_order_relaxed);
+    return alive;
+}
+
+} // anonymous namespace
+
+struct ShmIface::Ring
+{
+    /** Bytes written so far (modulo 2^32), updated by the sender. */
+    alignas(64) std::atomic<uint32_t> head;
+    /** Set while the receiver sleeps waiting for data. */
+    std::atomic<uint32_t> recvWaiting;
+    /** Bytes read so far (modulo 2^32), updated by the receiver. */
+    alignas(64) std::atomic<uint32_t> tail;
+    /** Set while the sender sleeps waiting for space. */
+    std::atomic<uint32_t> sendWaiting;
+    /** Set by the sender when it goes away. */
+    alignas(64) std::atomic<uint32_t> closed;
+    int32_t senderPid;
+    int32_t receiverPid;
+
+    alignas(64) uint8_t data[RingSize];
+};
+
+struct ShmIface::Channel
+{
+    struct NodeInfo
+    {
+        unsigned rank;
+        unsigned distIfaceId;
+        unsigned distIfaceNum;
+        int32_t pid;
+    };
+
+    uint32_t magic;
+    std::atomic<uint32_t> state;
+    /** Link info of the compute node. */
+    NodeInfo node;
+    /** Link info of the switch, valid once connected. */
+    NodeInfo ack;
+
+    /** Compute node to switch and switch to compute node rings. */
+    Ring rings[2];
+};
+
+std::vector<ShmIface *> ShmIface::registry;
+
+ShmIface::ShmIface(unsigned server_port, unsigned dist_rank,
+                   unsigned dist_size, Tick sync_start, Tick sync_repeat,
+                   EventManager *em, bool use_pseudo_op, bool adaptive_sync,
+                   bool is_switch, int num_nodes) :
+    DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
+              adaptive_sync, is_switch, num_nodes), channel(nullptr),
+    txRing(nullptr), rxRing(nullptr), serverPort(server_port),
+    isSwitch(is_switch)
+{
+}
+
+ShmIface::~ShmIface()
+{
+    if (!channel)
+        return;
+
+    if (channel->state.load() != Connected)
+        shm_unlink(channelName(rank, distIfaceId).c_str());
+
+    // Let the receiver on the other end know that we are gone.
+    txRing->closed.store(1);
+    wakeWord(txRing->head);
+
+    int M5_VAR_USED ret = munmap(channel, sizeof(Channel));
+    assert(ret == 0);
+}
+
+string
+ShmIface::channelName(unsigned node_rank, unsigned node_iface_id) const
+{
+    return csprintf("/gem5-dist-%d-%d-%d", serverPort, node_rank,
+                    node_iface_id);
+}
+
+void
+ShmIface::createChannel()
+{
+    const string name = channelName(rank, distIfaceId);
+
+    // Remove leftovers of an earlier run that didn't finish cleanly.
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    panic_if(fd < 0, "shm_open(%s) failed: %s", name, strerror(errno));
+    panic_if(ftruncate(fd, sizeof(Channel)) != 0,
+             "ftruncate(%s) failed: %s", name, strerror(errno));
+
+    void *mem = mmap(nullptr, sizeof(Channel), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    panic_if(mem == MAP_FAILED, "mmap(%s) failed: %s", name, strerror(errno));
+    close(fd);
+
+    // The memory is zero filled, which is a valid initial state for
+    // all the fields.
+    channel = (Channel *)mem;
+}
+
+void
+ShmIface::openChannel(unsigned node_rank, unsigned node_iface_id)
+{
+    const string name = channelName(node_rank, node_iface_id);
+    const struct timespec retry = { 0, 10 * 1000 * 1000 };
+
+    for (;;) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        panic_if(fd < 0 && errno != ENOENT,
+                 "shm_open(%s) failed: %s", name, strerror(errno));
+
+        // The compute node may not have created the link yet.
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 ||
+            st.st_size < (off_t)sizeof(Channel)) {
+            if (fd >= 0)
+                close(fd);
+            nanosleep(&retry, nullptr);
+            continue;
+        }
+
+        void *mem = mmap(nullptr, sizeof(Channel), PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+        panic_if(mem == MAP_FAILED, "mmap(%s) failed: %s",
+                 name, strerror(errno));
+        close(fd);
+        channel = (Channel *)mem;
+
+        while (channel->state.load() == Created)
+            waitWord(channel->state, Created);
+
+        panic_if(channel->magic != ChannelMagic,
+                 "%s is not a dist-gem5 link", name);
+
+        // Skip links left behind by a compute node that has died.
+        if (channel->state.load() == NodeReady &&
+            processAlive(channel->node.pid)) {
+            return;
+        }
+
+        munmap(channel, sizeof(Channel));
+        channel = nullptr;
+        nanosleep(&retry, nullptr);
+    }
+}
+
+void
+ShmIface::establishConnection()
+{
+    static unsigned cur_rank = 0;
+    static unsigned cur_id = 0;
+
+    if (isSwitch) {
+        openChannel(cur_rank, cur_id);
+        const Channel::NodeInfo ni = channel->node;
+        assert(ni.rank == cur_rank);
+        assert(ni.distIfaceId == cur_id);
+        inform("Link okay  (iface:%d -> (node:%d, iface:%d))",
+               distIfaceId, ni.rank, ni.distIfaceId);
+        if (ni.distIfaceId < ni.distIfaceNum - 1) {
+            cur_id++;
+        } else {
+            cur_rank++;
+            cur_id = 0;
+        }
+
+        rxRing = &channel->rings[0];
+        txRing = &channel->rings[1];
+        rxRing->receiverPid = getpid();
+        txRing->senderPid = getpid();
+        channel->ack = { ni.rank, distIfaceId, distIfaceNum, getpid() };
+
+        // Both ends have the link mapped now, so its name isn't needed
+        // anymore.
+        shm_unlink(channelName(ni.rank, ni.distIfaceId).c_str());
+
+        // send ack
+        channel->state.store(Connected);
+        wakeWord(channel->state);
+    } else { // this is not a switch
+        createChannel();
+        txRing = &channel->rings[0];
+        rxRing = &channel->rings[1];
+        txRing->senderPid = getpid();
+        rxRing->receiverPid = getpid();
+        channel->node = { rank, distIfaceId, distIfaceNum, getpid() };
+        channel->magic = ChannelMagic;
+
+        // send link info
+        channel->state.store(NodeReady);
+        wakeWord(channel->state);
+        DPRINTF(DistEthernet, "Link created, waiting for ack "
+                "(distIfaceId:%d)\n", distIfaceId);
+        while (channel->state.load() != Connected)
+            waitWord(channel->state, NodeReady);
+
+        assert(channel->ack.rank == rank);
+        inform("Link okay  (iface:%d -> switch iface:%d)", distIfaceId,
+               channel->ack.distIfaceId);
+    }
+    registry.push_back(this);
+}
+
+void
+ShmIface::sendShm(Ring &ring, const void *buf, unsigned length)
+{
+    const uint8_t *src = (const uint8_t *)buf;
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+
+    while (length > 0) {
+        const uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        const uint32_t space = RingSize - (head - tail);
+        if (space == 0) {
+            if (!waitIndex(ring.tail, tail, ring.sendWaiting,
+                           ring.receiverPid)) {
+                exitSimLoop("Message server closed connection, simulation "
+                            "is exiting");
+                return;
+            }
+            continue;
+        }
+
+        const uint32_t size = std::min(length, space);
+        const uint32_t offset = head & (RingSize - 1);
+        const uint32_t first = std::min(size, RingSize - offset);
+        memcpy(ring.data + offset, src, first);
+        memcpy(ring.data, src + first, size - first);
+
+        head += size;
+        src += size;
+        length -= size;
+
+        ring.head.store(head);
+        if (ring.recvWaiting.load())
+            wakeWord(ring.head);
+    }
+}
+
+bool
+ShmIface::recvShm(Ring &ring, void *buf, unsigned length)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    while (length > 0) {
+        const uint32_t head = ring.head.load(std::memory_order_acquire);
+        const uint32_t avail = head - tail;
+        if (avail == 0) {
+            if (ring.closed.load()) {
+                inform("recvShm(): Connection closed");
+                return false;
+            }
+            if (!waitIndex(ring.head, head, ring.recvWaiting,
+                           ring.senderPid)) {
+                inform("recvShm(): Peer process has exited");
+                return false;
+            }
+            continue;
+        }
+
+        const uint32_t size = std::min(length, avail);
+        const uint32_t offset = tail & (RingSize - 1);
+        const uint32_t first = std::min(size, RingSize - offset);
+        memcpy(dst, ring.data + offset, first);
+        memcpy(dst + first, ring.data, size - first);
+
+        tail += size;
+        dst += size;
+        length -= size;
+
+        ring.tail.store(tail);
+        if (ring.sendWaiting.load())
+            wakeWord(ring.tail);
+    }
+
+    return true;
+}
+
+void
+ShmIface::sendPacket(const Header &header, const EthPacketPtr &packet)
+{
+    sendShm(*txRing, &header, sizeof(header));
+    sendShm(*txRing, packet->data, packet->length);
+}
+
+void
+ShmIface::sendCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "ShmIface::sendCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    // Global commands (i.e. sync request) are always sent by the master
+    // DistIface to every link of this process.
+    for (auto iface : registry)
+        sendShm(*iface->txRing, &header, sizeof(header));
+}
+
+bool
+ShmIface::recvHeader(Header &header)
+{
+    bool ret = recvShm(*rxRing, &header, sizeof(header));
+    DPRINTF(DistEthernetCmd, "ShmIface::recvHeader() type: %d ret: %d\n",
+            static_cast<int>(header.msgType), ret);
+    return ret;
+}
+
+void
+ShmIface::recvPacket(const Header &header, EthPacketPtr &packet)
+{
+    packet = make_shared<EthPacketData>(header.dataPacketLength);
+    bool ret = recvShm(*rxRing, packet->data, header.dataPacketLength);
+    panic_if(!ret, "Error while reading shared memory");
+    packet->simLength = header.simLength;
+    packet->length = header.dataPacketLength;
+}
+
+void
+ShmIface::initTransport()
+{
+    // As with TCP, the links are set up in the init phase because the
+    // number of dist interfaces (per process) is needed for the global
+    // link ordering.
+    establishConnection();
+}
@@ -0,0 +1,159 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs.
+ *
+ * For a high level description about dist-gem5 see comments in
+ * header file dist_iface.hh.
+ *
+ * This transport can be used instead of the TCP one (tcp_iface.hh) if
+ * all the gem5 processes of a dist run are on the same host. Each
+ * simulated link between a compute node and the switch is a shared
+ * memory object (in /dev/shm on Linux) holding a single producer,
+ * single consumer byte ring for each direction. Messages are copied
+ * in and out of the rings without system calls; a receiver that runs
+ * out of data spins briefly and then sleeps on a futex until the
+ * sender wakes it up.
+ *
+ * The compute node creates the shared memory object of each of its
+ * links, the switch opens them in the same (rank, link) order the TCP
+ * transport accepts connections in and removes their names once the
+ * link is established.
+ */
+#ifndef __DEV_NET_SHM_IFACE_HH__
+#define __DEV_NET_SHM_IFACE_HH__
+
+#include <string>
+#include <vector>
+
+#include "dev/net/dist_iface.hh"
+
+class EventManager;
+
+class ShmIface : public DistIface
+{
+  private:
+    /** Layout of a ring in shared memory, see shm_iface.cc. */
+    struct Ring;
+    /** Layout of a link's shared memory object, see shm_iface.cc. */
+    struct Channel;
+
+    /** Shared memory of the link. */
+    Channel *channel;
+    /** Rings to send to and receive from the peer. */
+    Ring *txRing;
+    Ring *rxRing;
+
+    /** Key shared by all the processes of a dist run. */
+    unsigned serverPort;
+
+    bool isSwitch;
+
+    /**
+     * All the links of this process. Global commands (i.e. sync
+     * requests) are sent to every one of them.
+     */
+    static std::vector<ShmIface *> registry;
+
+  private:
+    /**
+     * Name of the shared memory object of a link.
+     *
+     * @param node_rank Rank of the compute node.
+     * @param node_iface_id Dist interface id within the compute node.
+     */
+    std::string channelName(unsigned node_rank,
+                            unsigned node_iface_id) const;
+
+    /** Create the shared memory of a link (compute node side). */
+    void createChannel();
+    /**
+     * Open the shared memory of a link created by a compute node
+     * (switch side).
+     *
+     * @param node_rank Rank of the compute node.
+     * @param node_iface_id Dist interface id within the compute node.
+     */
+    void openChannel(unsigned node_rank, unsigned node_iface_id);
+
+    void establishConnection();
+
+    /**
+     * Copy a message into a ring, waiting for the receiver to make
+     * room if needed.
+     *
+     * @param ring Ring to write to.
+     * @param buf Start address of the message.
+     * @param length Size of the message in bytes.
+     */
+    void sendShm(Ring &ring, const void *buf, unsigned length);
+
+    /**
+     * Copy the next message out of a ring, waiting for the sender if
+     * needed.
+     *
+     * @param ring Ring to read from.
+     * @param buf Start address of buffer to store the message.
+     * @param length Exact size of the expected message in bytes.
+     * @return false if the peer has gone away.
+     */
+    bool recvShm(Ring &ring, void *buf, unsigned length);
+
+  protected:
+
+    void sendPacket(const Header &header,
+                    const EthPacketPtr &packet) override;
+
+    void sendCmd(const Header &header) override;
+
+    bool recvHeader(Header &header) override;
+
+    void recvPacket(const Header &header, EthPacketPtr &packet) override;
+
+    void initTransport() override;
+
+  public:
+    /**
+     * The ctor only records the parameters, the shared memory of the
+     * link is set up by initTransport() once the number of dist
+     * interfaces in this process is known.
+     * @param server_port Key used to name the shared memory objects, it
+     * must be the same in every process of the dist run.
+     * @param sync_start The tick for the first dist synchronisation.
+     * @param sync_repeat The frequency of dist synchronisation.
+     * @param em The EventManager object associated with the simulated
+     * Ethernet link.
+     */
+    ShmIface(unsigned server_port, unsigned dist_rank, unsigned dist_size,
+             Tick sync_start, Tick sync_repeat, EventManager *em,
+             bool use_pseudo_op, bool adaptive_sync, bool is_switch,
+             int num_nodes);
+
+    ~ShmIface() override;
+};
+
+#endif // __DEV_NET_SHM_IFACE_HH__
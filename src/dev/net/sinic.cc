@@ -1150,7 +1150,7 @@ Device::rxFilter(const EthPacketPtr &packet)
 }
 
 bool
-Device::recvPacket(EthPacketPtr packet)
+Device::recvPacket(const EthPacketPtr &packet)
 {
     rxBytes += packet->length;
     rxPackets++;
@@ -228,7 +228,7 @@ class Device : public Base
  * device ethernet interface
  */
   public:
-    bool recvPacket(EthPacketPtr packet);
+    bool recvPacket(const EthPacketPtr &packet);
     void transferDone();
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
@@ -309,7 +309,11 @@ class Interface : public EtherInt
         : EtherInt(name), dev(d)
     { }
 
-    virtual bool recvPacket(EthPacketPtr pkt) { return dev->recvPacket(pkt); }
+    virtual bool
+    recvPacket(const EthPacketPtr &pkt)
+    {
+        return dev->recvPacket(pkt);
+    }
     virtual void sendDone() { dev->transferDone(); }
 };
 
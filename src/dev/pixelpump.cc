@@ -39,6 +39,8 @@
 
 #include "dev/pixelpump.hh"
 
+#include <algorithm>
+
 const DisplayTimings DisplayTimings::vga(
     640, 480,
     48, 96, 16,
@@ -89,6 +91,7 @@ BasePixelPump::BasePixelPump(EventManager &em, ClockDomain &pxl_clk,
                              unsigned pixel_chunk)
     : EventManager(em), Clocked(pxl_clk), Serializable(),
       pixelChunk(pixel_chunk),
+      pixelBuffer(pixel_chunk),
       pixelEvents(),
       evVSyncBegin("evVSyncBegin", this, &BasePixelPump::onVSyncBegin),
       evVSyncEnd("evVSyncEnd", this, &BasePixelPump::onVSyncEnd),
@@ -217,27 +220,32 @@ BasePixelPump::renderPixels()
     // Try to handle multiple pixels at a time; doing so reduces the
     // accuracy of the underrun detection but lowers simulation
     // overhead
-    const unsigned x_end(std::min(_posX + pixelChunk, _timings.width));
-    const unsigned pxl_count(x_end - _posX);
+    const unsigned x_begin(_posX);
+    const unsigned x_end(std::min(x_begin + pixelChunk, _timings.width));
+    const unsigned pxl_count(x_end - x_begin);
     const unsigned pos_y(posY());
 
-    Pixel pixel(0, 0, 0);
-    const Pixel underrun_pixel(0, 0, 0);
-    for (; _posX < x_end && !_underrun; ++_posX) {
-        if (!nextPixel(pixel)) {
+    unsigned count(0);
+    if (!_underrun) {
+        count = nextPixels(pixelBuffer.data(), pxl_count);
+        if (count < pxl_count) {
+            const unsigned pos_x(x_begin + count);
             warn("Input buffer underrun in BasePixelPump (%u, %u)\n",
-                 _posX, pos_y);
+                 pos_x, pos_y);
             _underrun = true;
-            onUnderrun(_posX, pos_y);
-            pixel = underrun_pixel;
+            _posX = pos_x;
+            onUnderrun(pos_x, pos_y);
         }
-        fb.pixel(_posX, pos_y) = pixel;
     }
 
     // Fill remaining pixels with a dummy pixel value if we ran out of
     // data
-    for (; _posX < x_end; ++_posX)
-        fb.pixel(_posX, pos_y) = underrun_pixel;
+    const Pixel underrun_pixel(0, 0, 0);
+    std::fill(pixelBuffer.begin() + count, pixelBuffer.begin() + pxl_count,
+              underrun_pixel);
+
+    fb.setPixels(x_begin, pos_y, pixelBuffer.data(), pxl_count);
+    _posX = x_end;
 
     // Schedule a new event to handle the next block of pixels
     if (_posX < _timings.width) {
@@ -285,14 +293,27 @@ BasePixelPump::renderLine()
 {
     const unsigned pos_y(posY());
 
-    Pixel pixel(0, 0, 0);
-    for (_posX = 0; _posX < _timings.width; ++_posX) {
-        if (!nextPixel(pixel)) {
+    for (_posX = 0; _posX < _timings.width; ) {
+        const unsigned pxl_count(
+            std::min(pixelChunk, _timings.width - _posX));
+        const unsigned count(nextPixels(pixelBuffer.data(), pxl_count));
+        if (count != pxl_count) {
             panic("Unexpected underrun in BasePixelPump (%u, %u)\n",
-                 _posX, pos_y);
+                 _posX + count, pos_y);
         }
-        fb.pixel(_posX, pos_y) = pixel;
+        fb.setPixels(_posX, pos_y, pixelBuffer.data(), pxl_count);
+        _posX += pxl_count;
+    }
+}
+
+unsigned
+BasePixelPump::nextPixels(Pixel *p, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i) {
+        if (!nextPixel(p[i]))
+            return i;
     }
+    return count;
 }
 
 
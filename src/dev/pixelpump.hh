@@ -203,6 +203,19 @@ class BasePixelPump
      */
     virtual bool nextPixel(Pixel &p) = 0;
 
+    /**
+     * Get a run of pixels from the scan line buffer.
+     *
+     * The default implementation calls nextPixel() for every
+     * pixel. Devices that can convert several pixels at a time should
+     * override it.
+     *
+     * @param p Output pixels, undefined past the returned count
+     * @param count Number of pixels requested
+     * @return Number of pixels read, less than count on buffer underrun
+     */
+    virtual unsigned nextPixels(Pixel *p, unsigned count);
+
     /** First pixel clock of the first VSync line. */
     virtual void onVSyncBegin() {};
 
@@ -295,6 +308,9 @@ class BasePixelPump
     /** Fast and event-free line rendering function */
     void renderLine();
 
+    /** Scratch buffer holding a chunk of pixels being rendered */
+    std::vector<Pixel> pixelBuffer;
+
     /** Convenience vector when doing operations on all events */
     std::vector<PixelEvent *> pixelEvents;
 
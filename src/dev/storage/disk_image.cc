@@ -34,15 +34,19 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/callback.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -53,12 +57,36 @@
 
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////
+//
+// Disk image
+//
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                       size_t count) const
+{
+    std::streampos bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+        bytes += read(data + i * SectorSize, offset + (std::streamoff)i);
+    return bytes;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        size_t count)
+{
+    std::streampos bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+        bytes += write(data + i * SectorSize, offset + (std::streamoff)i);
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
 //
 RawDiskImage::RawDiskImage(const Params* p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), fd(-1), disk_size(0)
 { open(p->image_file, p->read_only); }
 
 RawDiskImage::~RawDiskImage()
@@ -83,11 +111,8 @@ RawDiskImage::open(const string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
-        ios::openmode mode = ios::in | ios::binary;
-        if (!readonly)
-            mode |= ios::out;
-        stream.open(file.c_str(), mode);
-        if (!stream.is_open())
+        fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+        if (fd < 0)
             panic("Error opening %s", filename);
     }
 }
@@ -95,17 +120,22 @@ RawDiskImage::open(const string &filename, bool rd_only)
 void
 RawDiskImage::close()
 {
-    stream.close();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
 }
 
 std::streampos
 RawDiskImage::size() const
 {
     if (disk_size == 0) {
-        if (!stream.is_open())
+        if (fd < 0)
             panic("file not open!\n");
-        stream.seekg(0, ios::end);
-        disk_size = stream.tellg();
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+            panic("Could not get the size of %s", file);
+        disk_size = st.st_size;
     }
 
     return disk_size / SectorSize;
@@ -113,28 +143,50 @@ RawDiskImage::size() const
 
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          size_t count) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekg(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
-
-    streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    const size_t len = count * SectorSize;
+    const off_t pos = (off_t)offset * SectorSize;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = pread(fd, data + done, len - done, pos + done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0)
+            panic("Could not read from %s: %s", file, strerror(errno));
+        if (ret == 0)
+            break;
+        done += ret;
+    }
 
-    DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageRead, data, SectorSize);
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, done);
 
-    return stream.tellg() - pos;
+    return done;
 }
 
 std::streampos
-RawDiskImage::write(const uint8_t *data, std::streampos offset)
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           size_t count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -142,19 +194,26 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (readonly)
         panic("Cannot write to a read only disk image");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekp(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
-
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
+
+    const size_t len = count * SectorSize;
+    const off_t pos = (off_t)offset * SectorSize;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t ret = pwrite(fd, data + done, len - done, pos + done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0)
+            panic("Could not write to %s: %s", file, strerror(errno));
+        done += ret;
+    }
 
-    streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
-    return stream.tellp() - pos;
+    return done;
 }
 
 RawDiskImage *
@@ -181,7 +240,7 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child)
 {
     if (filename.empty()) {
         initSectorTable(p->table_size);
@@ -199,13 +258,6 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        delete (*i).second;
-        ++i;
-    }
 }
 
 void
@@ -273,18 +325,19 @@ CowDiskImage::open(const string &file)
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
-
+    table.clear();
+    table.reserve(sector_count / ClusterSectors);
 
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
+        Cluster &cluster = getCluster(offset / ClusterSectors);
+        const unsigned idx = offset % ClusterSectors;
+        SafeRead(stream, cluster.data + idx * SectorSize, SectorSize);
 
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        assert(!bits(cluster.valid, idx));
+        cluster.valid |= ULL(1) << idx;
     }
 
     stream.close();
@@ -296,7 +349,8 @@ CowDiskImage::open(const string &file)
 void
 CowDiskImage::initSectorTable(int hash_size)
 {
-    table = new SectorTable(hash_size);
+    table.clear();
+    table.reserve(hash_size / ClusterSectors);
 
     initialized = true;
 }
@@ -355,19 +409,21 @@ CowDiskImage::save(const string &file) const
 
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
-
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
 
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
-
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+    uint64_t size = 0;
+    for (const auto &entry : table)
+        size += popCount(entry.second->valid);
+    SafeWriteSwap(stream, size);
+
+    for (const auto &entry : table) {
+        const uint64_t base = entry.first * ClusterSectors;
+        const Cluster &cluster = *entry.second;
+        for (unsigned i = 0; i < ClusterSectors; i++) {
+            if (!bits(cluster.valid, i))
+                continue;
+            SafeWriteSwap(stream, base + i);
+            SafeWrite(stream, cluster.data + i * SectorSize, SectorSize);
+        }
     }
 
     stream.close();
@@ -376,12 +432,18 @@ CowDiskImage::save(const string &file) const
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    for (const auto &entry : table) {
+        const uint64_t base = entry.first * ClusterSectors;
+        const Cluster &cluster = *entry.second;
+        unsigned i = 0;
+        while (i < ClusterSectors) {
+            const unsigned first = nextRun(cluster.valid, i, true);
+            if (first == ClusterSectors)
+                break;
+            i = nextRun(cluster.valid, first, false);
+            child->writeSectors(cluster.data + first * SectorSize,
+                                base + first, i - first);
+        }
     }
 }
 
@@ -389,48 +451,126 @@ std::streampos
 CowDiskImage::size() const
 { return child->size(); }
 
+CowDiskImage::Cluster &
+CowDiskImage::getCluster(uint64_t index)
+{
+    std::unique_ptr<Cluster> &cluster = table[index];
+    if (!cluster) {
+        cluster.reset(new Cluster);
+        cluster->valid = 0;
+    }
+    return *cluster;
+}
+
+unsigned
+CowDiskImage::nextRun(uint64_t valid, unsigned start, bool set)
+{
+    if (start >= ClusterSectors)
+        return ClusterSectors;
+    const uint64_t pending = (set ? valid : ~valid) >> start;
+    if (pending == 0)
+        return ClusterSectors;
+    return start + findLsbSet(pending);
+}
+
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          size_t count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    if (offset + (std::streamoff)count > size())
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+    // Copy the valid sectors of every cluster touched and read the runs
+    // of sectors in between from the child with as few calls as possible.
+    const uint64_t begin = offset;
+    const uint64_t last = begin + count;
+    uint64_t sector = begin;
+    uint64_t childStart = begin;
+    uint8_t *childData = data;
+    while (sector < last) {
+        const uint64_t index = sector / ClusterSectors;
+        const unsigned first = sector % ClusterSectors;
+        const unsigned end = std::min<uint64_t>(ClusterSectors,
+                                                first + last - sector);
+
+        ClusterTable::const_iterator i = table.find(index);
+        const uint64_t valid = i == table.end() ? 0 : i->second->valid;
+        const uint64_t base = index * ClusterSectors;
+        unsigned s = first;
+        while (s < end) {
+            const unsigned run = nextRun(valid, s, true);
+            if (run >= end)
+                break;
+            s = std::min(nextRun(valid, run, false), end);
+
+            if (base + run > childStart) {
+                child->readSectors(childData, childStart,
+                                   base + run - childStart);
+            }
+            memcpy(data + (base + run - begin) * SectorSize,
+                   i->second->data + run * SectorSize,
+                   (s - run) * SectorSize);
+            childStart = base + s;
+            childData = data + (childStart - begin) * SectorSize;
+        }
+        sector += end - first;
     }
+    if (last > childStart)
+        child->readSectors(childData, childStart, last - childStart);
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, count * SectorSize);
+
+    return count * SectorSize;
 }
 
 std::streampos
-CowDiskImage::write(const uint8_t *data, std::streampos offset)
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           size_t count)
 {
     if (!initialized)
-        panic("RawDiskImage not initialized");
+        panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    if (offset + (std::streamoff)count > size())
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
+    uint64_t sector = offset;
+    const uint64_t last = sector + count;
+    const uint8_t *src = data;
+    while (sector < last) {
+        const unsigned first = sector % ClusterSectors;
+        const unsigned n = std::min<uint64_t>(ClusterSectors - first,
+                                              last - sector);
+
+        Cluster &cluster = getCluster(sector / ClusterSectors);
+        memcpy(cluster.data + first * SectorSize, src, n * SectorSize);
+        cluster.valid |= mask(n) << first;
+
+        sector += n;
+        src += n * SectorSize;
     }
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
@@ -36,6 +36,7 @@
 #define __DEV_STORAGE_DISK_IMAGE_HH__
 
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 
 #include "params/CowDiskImage.hh"
@@ -64,15 +65,41 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read a number of consecutive sectors. The default implementation
+     * reads them one at a time.
+     *
+     * @param data Buffer of count * SectorSize bytes.
+     * @param offset First sector to read.
+     * @param count Number of sectors to read.
+     * @return Number of bytes read.
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       size_t count) const;
+
+    /**
+     * Write a number of consecutive sectors. The default implementation
+     * writes them one at a time.
+     *
+     * @param data Buffer of count * SectorSize bytes.
+     * @param offset First sector to write.
+     * @param count Number of sectors to write.
+     * @return Number of bytes written.
+     */
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset, size_t count);
 };
 
 /**
- * Specialization for accessing a raw disk image
+ * Specialization for accessing a raw disk image. The image is accessed
+ * with pread/pwrite, so any number of sectors costs a single system
+ * call and no seek.
  */
 class RawDiskImage : public DiskImage
 {
   protected:
-    mutable std::fstream stream;
+    int fd;
     std::string file;
     bool readonly;
     mutable std::streampos disk_size;
@@ -91,6 +118,11 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               size_t count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                size_t count) override;
 };
 
 /**
@@ -102,6 +134,11 @@ class RawDiskImage : public DiskImage
  * This object is designed to provide a mechanism for persistant
  * changes to a main disk image, or to provide a place for temporary
  * changes to the image to take place that later may be thrown away.
+ *
+ * Modified sectors are kept in clusters of consecutive sectors, with a
+ * bitmap of the sectors of the cluster that have been written. Sectors
+ * that haven't been written are read from the child in runs. The file
+ * format still stores individual sectors.
  */
 class CowDiskImage : public DiskImage
 {
@@ -110,15 +147,31 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMinor;
 
   protected:
-    struct Sector {
-        uint8_t data[SectorSize];
+    /** Number of sectors in a cluster, the unit of allocation. */
+    static const unsigned ClusterSectors = 64;
+
+    struct Cluster {
+        /** Bitmap of the sectors of the cluster that are valid. */
+        uint64_t valid;
+        uint8_t data[ClusterSectors * SectorSize];
     };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
+    /** Clusters indexed by their first sector / ClusterSectors. */
+    typedef std::unordered_map<uint64_t, std::unique_ptr<Cluster>>
+        ClusterTable;
 
   protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+    ClusterTable table;
+
+    /** Get the cluster at index, allocating it if needed. */
+    Cluster &getCluster(uint64_t index);
+
+    /**
+     * Find the first sector at or after start whose valid bit is set
+     * (or clear), ClusterSectors if there is none.
+     */
+    static unsigned nextRun(uint64_t valid, unsigned start, bool set);
 
   public:
     typedef CowDiskImageParams Params;
@@ -140,6 +193,11 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               size_t count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                size_t count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
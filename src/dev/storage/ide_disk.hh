@@ -335,8 +335,8 @@ class IdeDisk : public SimObject
     EventFunctionWrapper dmaWriteEvent;
 
     // Disk image read/write
-    void readDisk(uint32_t sector, uint8_t *data);
-    void writeDisk(uint32_t sector, uint8_t *data);
+    void readDisk(uint32_t sector, uint8_t *data, uint32_t count);
+    void writeDisk(uint32_t sector, uint8_t *data, uint32_t count);
 
     // State machine management
     void updateState(DevAction_t action);
@@ -40,14 +40,14 @@
 #include "dev/virtio/base.hh"
 
 #include "debug/VIO.hh"
+#include "mem/physical.hh"
 #include "params/VirtIODeviceBase.hh"
 #include "params/VirtIODummyDevice.hh"
 #include "sim/system.hh"
 
-VirtDescriptor::VirtDescriptor(PortProxy &_memProxy, ByteOrder bo,
-                               VirtQueue &_queue, Index descIndex)
-    : memProxy(&_memProxy), queue(&_queue), byteOrder(bo), _index(descIndex),
-      desc{0, 0, 0, 0}
+VirtDescriptor::VirtDescriptor(ByteOrder bo, VirtQueue &_queue,
+                               Index descIndex)
+    : queue(&_queue), byteOrder(bo), _index(descIndex), desc{0, 0, 0, 0}
 {
 }
 
@@ -63,7 +63,6 @@ VirtDescriptor::~VirtDescriptor() noexcept
 VirtDescriptor &
 VirtDescriptor::operator=(VirtDescriptor &&rhs) noexcept
 {
-    memProxy = std::move(rhs.memProxy);
     queue = std::move(rhs.queue);
     byteOrder = std::move(rhs.byteOrder);
     _index = std::move(rhs._index);
@@ -83,7 +82,7 @@ VirtDescriptor::update()
     assert(_index < queue->getSize());
     const Addr desc_addr(vq_addr + sizeof(desc) * _index);
     vring_desc guest_desc;
-    memProxy->readBlob(desc_addr, &guest_desc, sizeof(guest_desc));
+    queue->readGuest(desc_addr, &guest_desc, sizeof(guest_desc));
     desc = gtoh(guest_desc, byteOrder);
     DPRINTF(VIO,
             "VirtDescriptor(%i): Addr: 0x%x, Len: %i, Flags: 0x%x, "
@@ -151,7 +150,7 @@ VirtDescriptor::read(size_t offset, uint8_t *dst, size_t size) const
     if (!isIncoming())
         panic("Trying to read from outgoing buffer\n");
 
-    memProxy->readBlob(desc.addr + offset, dst, size);
+    queue->readGuest(desc.addr + offset, dst, size);
 }
 
 void
@@ -163,7 +162,7 @@ VirtDescriptor::write(size_t offset, const uint8_t *src, size_t size)
     if (!isOutgoing())
         panic("Trying to write to incoming buffer\n");
 
-    memProxy->writeBlob(desc.addr + offset, src, size);
+    queue->writeGuest(desc.addr + offset, src, size);
 }
 
 void
@@ -224,16 +223,52 @@ VirtDescriptor::chainSize() const
     return size;
 }
 
+bool
+VirtDescriptor::chainHostSpans(size_t offset, size_t size, bool outgoing,
+                               std::vector<HostSpan> &spans) const
+{
+    const VirtDescriptor *desc(this);
+    do {
+        if (offset < desc->size()) {
+            if (outgoing && !desc->isOutgoing())
+                panic("Trying to write to incoming buffer\n");
+            else if (!outgoing && !desc->isIncoming())
+                panic("Trying to read from outgoing buffer\n");
+
+            const size_t chunk_size(std::min(desc->size() - offset, size));
+            uint8_t *ptr(queue->hostPtr(desc->desc.addr + offset, chunk_size));
+            if (!ptr)
+                return false;
+
+            // Merge buffers that are adjacent in host memory.
+            if (!spans.empty() &&
+                spans.back().first + spans.back().second == ptr) {
+                spans.back().second += chunk_size;
+            } else {
+                spans.emplace_back(ptr, chunk_size);
+            }
+            size -= chunk_size;
+            offset = 0;
+        } else {
+            offset -= desc->size();
+        }
+    } while ((desc = desc->next()) != NULL &&
+             (outgoing || desc->isIncoming()) && size > 0);
+
+    return size == 0;
+}
+
 
 
 VirtQueue::VirtQueue(PortProxy &proxy, ByteOrder bo, uint16_t size)
     : byteOrder(bo), _size(size), _address(0), memProxy(proxy),
+      system(NULL), hostMemoriesValid(false),
       avail(proxy, bo, size), used(proxy, bo, size),
       _last_avail(0)
 {
     descriptors.reserve(_size);
     for (int i = 0; i < _size; ++i)
-        descriptors.emplace_back(proxy, bo, *this, i);
+        descriptors.emplace_back(bo, *this, i);
 }
 
 void
@@ -267,17 +302,80 @@ VirtQueue::setAddress(Addr address)
     _address = address;
     avail.setAddress(addr_avail);
     used.setAddress(addr_used);
+
+    // Nothing has been fetched from the new ring yet.
+    avail.header.index = _last_avail;
+}
+
+uint8_t *
+VirtQueue::hostPtr(Addr addr, size_t size) const
+{
+    if (!system || !system->bypassCaches())
+        return NULL;
+
+    // The backing store is created by the system, which may not exist
+    // yet when the queue is registered, so look it up lazily.
+    if (!hostMemoriesValid) {
+        for (const auto &entry : system->getPhysMem().getBackingStore()) {
+            if (entry.inAddrMap && !entry.range.interleaved()) {
+                hostMemories.push_back(HostMemory{
+                    entry.range.start(), entry.range.end(), entry.pmem });
+            }
+        }
+        hostMemoriesValid = true;
+    }
+
+    for (const HostMemory &mem : hostMemories) {
+        if (addr >= mem.start && addr < mem.end &&
+            size <= mem.end - addr) {
+            return mem.pmem + (addr - mem.start);
+        }
+    }
+
+    return NULL;
+}
+
+void
+VirtQueue::readGuest(Addr addr, void *dst, size_t size) const
+{
+    const uint8_t *ptr(hostPtr(addr, size));
+    if (ptr)
+        memcpy(dst, ptr, size);
+    else
+        memProxy.readBlob(addr, dst, size);
+}
+
+void
+VirtQueue::writeGuest(Addr addr, const void *src, size_t size) const
+{
+    uint8_t *ptr(hostPtr(addr, size));
+    if (ptr)
+        memcpy(ptr, src, size);
+    else
+        memProxy.writeBlob(addr, src, size);
 }
 
 VirtDescriptor *
 VirtQueue::consumeDescriptor()
 {
-    avail.read();
+    if (_last_avail == avail.header.index) {
+        // All fetched entries have been consumed, fetch the entries
+        // the guest has added since.
+        avail.readHeader();
+        const uint16_t pending(avail.header.index - _last_avail);
+        if (pending == 0)
+            return NULL;
+
+        if (pending > _size) {
+            panic("Guest made %i descriptors available in a queue of %i\n",
+                  pending, _size);
+        }
+        avail.readElements(_last_avail, pending);
+    }
+
     DPRINTF(VIO, "consumeDescriptor: _last_avail: %i, avail.idx: %i (->%i)\n",
             _last_avail, avail.header.index,
             avail.ring[_last_avail % used.ring.size()]);
-    if (_last_avail == avail.header.index)
-        return NULL;
 
     VirtDescriptor::Index index(avail.ring[_last_avail % used.ring.size()]);
     ++_last_avail;
@@ -298,8 +396,9 @@ VirtQueue::produceDescriptor(VirtDescriptor *desc, uint32_t len)
     struct vring_used_elem &e(used.ring[used.header.index % used.ring.size()]);
     e.id = desc->index();
     e.len = len;
+    used.writeElement(used.header.index);
     used.header.index += 1;
-    used.write();
+    used.writeHeader();
 }
 
 void
@@ -480,6 +579,7 @@ void
 VirtIODeviceBase::registerQueue(VirtQueue &queue)
 {
     _queues.push_back(&queue);
+    queue.setSystem(dynamic_cast<const Params *>(params())->system);
 }
 
 
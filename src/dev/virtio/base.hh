@@ -40,6 +40,10 @@
 #ifndef __DEV_VIRTIO_BASE_HH__
 #define __DEV_VIRTIO_BASE_HH__
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "arch/isa_traits.hh"
 #include "base/bitunion.hh"
 #include "base/callback.hh"
@@ -50,6 +54,7 @@
 struct VirtIODeviceBaseParams;
 struct VirtIODummyDeviceParams;
 
+class System;
 class VirtQueue;
 
 /** @{
@@ -117,12 +122,10 @@ class VirtDescriptor
     /**
      * Create a descriptor wrapper.
      *
-     * @param memProxy Proxy to the guest physical memory.
      * @param queue Queue owning this descriptor.
      * @param index Index within the queue.
      */
-    VirtDescriptor(PortProxy &memProxy, ByteOrder bo,
-            VirtQueue &queue, Index index);
+    VirtDescriptor(ByteOrder bo, VirtQueue &queue, Index index);
     // WORKAROUND: The noexcept declaration works around a bug where
     // gcc 4.7 tries to call the wrong constructor when emplacing
     // something into a vector.
@@ -258,6 +261,35 @@ class VirtDescriptor
      * @return Size of descriptor chain in bytes.
      */
     size_t chainSize() const;
+
+    /** A buffer in host memory: start and size in bytes. */
+    typedef std::pair<uint8_t *, size_t> HostSpan;
+
+    /**
+     * Resolve part of a descriptor chain into host memory.
+     *
+     * This method maps the specified number of bytes of a descriptor
+     * chain, starting at this descriptor plus an offset in bytes, to
+     * buffers in host memory that the device model can access
+     * directly. It fails if any part of the range can't be accessed
+     * directly (see VirtQueue::hostPtr()), in which case device
+     * models need to fall back to chainRead() and chainWrite().
+     *
+     * As with chainRead() and chainWrite(), the descriptors must
+     * match the direction of the access: incoming (read only)
+     * buffers for reads and outgoing (write only) buffers for
+     * writes.
+     *
+     * @param offset Offset into the chain (in bytes).
+     * @param size Size (in bytes).
+     * @param outgoing true if the device writes to the buffers,
+     * false if it reads from them.
+     * @param spans Vector the host buffers are appended to.
+     * @return true on success, false if the range needs to be
+     * accessed through the memory proxy.
+     */
+    bool chainHostSpans(size_t offset, size_t size, bool outgoing,
+                        std::vector<HostSpan> &spans) const;
     /** @} */
 
   private:
@@ -266,8 +298,6 @@ class VirtDescriptor
     // Prevent copying
     VirtDescriptor(const VirtDescriptor &other);
 
-    /** Pointer to memory proxy */
-    PortProxy *memProxy;
     /** Pointer to virtqueue owning this descriptor */
     VirtQueue *queue;
 
@@ -335,6 +365,33 @@ public:
     VirtDescriptor *getDescriptor(VirtDescriptor::Index index) {
         return &descriptors[index];
     }
+
+    /**
+     * Let the queue access guest memory directly.
+     *
+     * Guest memory is accessed through the host pointers of the
+     * system's backing store instead of functional accesses whenever
+     * the system bypasses caches (i.e., in the memory mode used by
+     * hardware virtualized CPUs), where memory is always up to date.
+     *
+     * @param sys System owning the guest memory.
+     */
+    void setSystem(System *sys) { system = sys; }
+
+    /**
+     * Get a host pointer to a range of guest physical memory.
+     *
+     * @param addr Guest physical start address.
+     * @param size Size of the range (in bytes).
+     * @return Host pointer to the range, or NULL if the range must be
+     * accessed through the memory proxy.
+     */
+    uint8_t *hostPtr(Addr addr, size_t size) const;
+
+    /** Read guest memory, directly if possible. */
+    void readGuest(Addr addr, void *dst, size_t size) const;
+    /** Write guest memory, directly if possible. */
+    void writeGuest(Addr addr, const void *src, size_t size) const;
     /** @} */
 
     /** @{
@@ -343,6 +400,10 @@ public:
     /**
      * Get an incoming descriptor chain from the queue.
      *
+     * Entries of the available ring are fetched in batches: the
+     * ring is only read from the guest once all the entries fetched
+     * by the previous read have been consumed.
+     *
      * @return Pointer to descriptor on success, NULL if no pending
      * descriptors are available.
      */
@@ -438,6 +499,18 @@ public:
     /** Guest physical memory proxy */
     PortProxy &memProxy;
 
+    /** System used to access guest memory directly, if any. */
+    System *system;
+
+    /** Guest memory that can be accessed directly. */
+    struct HostMemory {
+        Addr start;
+        Addr end; // Exclusive
+        uint8_t *pmem;
+    };
+    mutable std::vector<HostMemory> hostMemories;
+    mutable bool hostMemoriesValid;
+
   private:
     /**
      * VirtIO ring buffer wrapper.
@@ -502,6 +575,47 @@ public:
                 ring[i] = gtoh(temp[i], byteOrder);
         }
 
+        /**
+         * Update a range of elements in the ring with data from the
+         * guest. The range may wrap around the end of the ring.
+         *
+         * @param first Index (modulo the ring size) of the first element.
+         * @param count Number of elements to read.
+         */
+        void
+        readElements(Index first, Index count)
+        {
+            assert(_base != 0);
+            assert(count <= ring.size());
+
+            T temp[count];
+            const Index start = first % ring.size();
+            const Index head = std::min<Index>(count, ring.size() - start);
+            _proxy.readBlob(_base + sizeof(header) + start * sizeof(T),
+                            temp, sizeof(T) * head);
+            if (head < count) {
+                _proxy.readBlob(_base + sizeof(header),
+                                temp + head, sizeof(T) * (count - head));
+            }
+            for (Index i = 0; i < count; ++i)
+                ring[(start + i) % ring.size()] = gtoh(temp[i], byteOrder);
+        }
+
+        /**
+         * Write a single element of the ring to the guest.
+         *
+         * @param idx Index (modulo the ring size) of the element.
+         */
+        void
+        writeElement(Index idx)
+        {
+            assert(_base != 0);
+            const Index pos = idx % ring.size();
+            const T out = htog(ring[pos], byteOrder);
+            _proxy.writeBlob(_base + sizeof(header) + pos * sizeof(T),
+                             &out, sizeof(T));
+        }
+
         void
         write()
         {
@@ -0,0 +1,186 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dev/virtio/base.hh"
+#include "mem/packet.hh"
+#include "sim/eventq.hh"
+
+namespace {
+
+const Addr queueAddr = 0x1000;
+const uint16_t queueSize = 4;
+
+// A virtio-blk style request: a device-readable header, a data
+// buffer and a device-writable status byte.
+const Addr headerAddr = 0x100;
+const uint32_t headerSize = 16;
+const Addr dataAddr = 0x200;
+const uint32_t dataSize = 512;
+const Addr statusAddr = 0x800;
+const uint32_t statusSize = 1;
+
+/** Guest memory accessed through a functional port proxy */
+class GuestMemory
+{
+  public:
+    GuestMemory()
+        : data(0x2000),
+          proxy([this](PacketPtr pkt) {
+                  uint8_t *ptr(data.data() + pkt->getAddr());
+                  if (pkt->isRead())
+                      pkt->setData(ptr);
+                  else
+                      pkt->writeData(ptr);
+              }, 64)
+    {}
+
+    std::vector<uint8_t> data;
+    PortProxy proxy;
+};
+
+class TestQueue : public VirtQueue
+{
+  public:
+    TestQueue(PortProxy &proxy)
+        : VirtQueue(proxy, LittleEndianByteOrder, queueSize)
+    {}
+
+    std::string name() const { return "queue"; }
+};
+
+class VirtDescriptorTest : public ::testing::Test
+{
+  protected:
+    VirtDescriptorTest()
+        : eventQueue("VirtDescriptorTest"), queue(mem.proxy)
+    {
+        // Functional accesses are timestamped with curTick().
+        curEventQueue(&eventQueue);
+    }
+
+    ~VirtDescriptorTest() { curEventQueue(nullptr); }
+
+    /** Store a descriptor in the guest's descriptor table */
+    void
+    setDescriptor(VirtDescriptor::Index index, Addr addr, uint32_t len,
+                  uint16_t flags, uint16_t next)
+    {
+        const vring_desc desc{ htog(addr, LittleEndianByteOrder),
+                               htog(len, LittleEndianByteOrder),
+                               htog(flags, LittleEndianByteOrder),
+                               htog(next, LittleEndianByteOrder) };
+        std::memcpy(mem.data.data() + queueAddr + index * sizeof(desc),
+                    &desc, sizeof(desc));
+    }
+
+    /**
+     * Build a request chain and return its head.
+     *
+     * @param outgoing true if the device writes the data buffer
+     * (a read request), false if it reads it (a write request).
+     */
+    VirtDescriptor *
+    request(bool outgoing)
+    {
+        const uint16_t data_flags(
+            VRING_DESC_F_NEXT | (outgoing ? VRING_DESC_F_WRITE : 0));
+        setDescriptor(0, headerAddr, headerSize, VRING_DESC_F_NEXT, 1);
+        setDescriptor(1, dataAddr, dataSize, data_flags, 2);
+        setDescriptor(2, statusAddr, statusSize, VRING_DESC_F_WRITE, 0);
+
+        queue.setAddress(queueAddr);
+        VirtDescriptor *head(queue.getDescriptor(0));
+        head->updateChain();
+        return head;
+    }
+
+    EventQueue eventQueue;
+    GuestMemory mem;
+    TestQueue queue;
+};
+
+} // anonymous namespace
+
+TEST_F(VirtDescriptorTest, ReadRequestChain)
+{
+    VirtDescriptor *head(request(true));
+    ASSERT_EQ(head->chainSize(), headerSize + dataSize + statusSize);
+
+    // The device reads the header and writes the data buffer.
+    std::vector<uint8_t> header(headerSize);
+    head->chainRead(0, header.data(), header.size());
+
+    const std::vector<uint8_t> data(dataSize, 0xa5);
+    head->chainWrite(headerSize, data.data(), data.size());
+    EXPECT_EQ(std::vector<uint8_t>(mem.data.begin() + dataAddr,
+                                   mem.data.begin() + dataAddr + dataSize),
+              data);
+
+    // Mapping the data buffer skips the header without checking its
+    // direction. Without a system, nothing can be accessed directly.
+    std::vector<VirtDescriptor::HostSpan> spans;
+    EXPECT_FALSE(head->chainHostSpans(headerSize, dataSize, true, spans));
+    EXPECT_TRUE(spans.empty());
+}
+
+TEST_F(VirtDescriptorTest, WriteRequestChain)
+{
+    VirtDescriptor *head(request(false));
+
+    // The device reads both the header and the data buffer.
+    std::vector<uint8_t> buffer(headerSize + dataSize);
+    head->chainRead(0, buffer.data(), buffer.size());
+
+    std::vector<VirtDescriptor::HostSpan> spans;
+    EXPECT_FALSE(head->chainHostSpans(headerSize, dataSize, false, spans));
+    EXPECT_FALSE(head->chainHostSpans(0, headerSize + dataSize, false,
+                                      spans));
+    EXPECT_TRUE(spans.empty());
+}
+
+TEST_F(VirtDescriptorTest, HostSpansDirection)
+{
+    VirtDescriptor *head(request(true));
+    std::vector<VirtDescriptor::HostSpan> spans;
+
+    // Descriptors that are part of the range must match the
+    // direction of the access.
+    EXPECT_DEATH(head->chainHostSpans(0, headerSize, true, spans),
+                 "Trying to write to incoming buffer");
+    EXPECT_DEATH(queue.getDescriptor(2)->chainHostSpans(0, statusSize, false,
+                                                        spans),
+                 "Trying to read from outgoing buffer");
+
+    // Like chainRead(), reads stop at the first device-writable
+    // descriptor.
+    EXPECT_FALSE(head->chainHostSpans(0, headerSize + dataSize, false,
+                                      spans));
+}
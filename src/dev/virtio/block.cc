@@ -43,6 +43,22 @@
 #include "params/VirtIOBlock.hh"
 #include "sim/system.hh"
 
+namespace
+{
+
+/** Check that host buffers only hold whole sectors. */
+bool
+wholeSectors(const std::vector<VirtDescriptor::HostSpan> &spans)
+{
+    for (const auto &span : spans) {
+        if (span.second % SectorSize != 0)
+            return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 VirtIOBlock::VirtIOBlock(Params *params)
     : VirtIODeviceBase(params, ID_BLOCK, sizeof(Config), 0),
       qRequests(params->system->physProxy, byteOrder,
@@ -72,7 +88,6 @@ VirtIOBlock::Status
 VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
                   size_t off_data, size_t size)
 {
-    std::vector<uint8_t> data(size);
     uint64_t sector(req.sector);
 
     DPRINTF(VIOBlock, "Read request starting @ sector %i (size: %i)\n",
@@ -81,12 +96,30 @@ VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.read(&data[offset], sector) != SectorSize) {
-            warn("Failed to read sector %i\n", sector);
-            return S_IOERR;
+    // Read straight into guest memory if it can be accessed directly.
+    std::vector<VirtDescriptor::HostSpan> spans;
+    if (desc_chain->chainHostSpans(off_data, size, true, spans) &&
+        wholeSectors(spans)) {
+        for (const auto &span : spans) {
+            const size_t count(span.second / SectorSize);
+            const size_t done = image.readSectors(span.first, sector, count);
+            if (done != span.second) {
+                warn("Failed to read sectors %i-%i\n", sector,
+                     sector + count - 1);
+                return S_IOERR;
+            }
+            sector += count;
         }
-        ++sector;
+        return S_OK;
+    }
+
+    std::vector<uint8_t> data(size);
+    const size_t done = image.readSectors(data.data(), sector,
+                                          size / SectorSize);
+    if (done != size) {
+        warn("Failed to read sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     desc_chain->chainWrite(off_data, &data[0], size);
@@ -98,7 +131,6 @@ VirtIOBlock::Status
 VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
                   size_t off_data, size_t size)
 {
-    std::vector<uint8_t> data(size);
     uint64_t sector(req.sector);
 
     DPRINTF(VIOBlock, "Write request starting @ sector %i (size: %i)\n",
@@ -107,15 +139,33 @@ VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
+    // Write straight from guest memory if it can be accessed directly.
+    std::vector<VirtDescriptor::HostSpan> spans;
+    if (desc_chain->chainHostSpans(off_data, size, false, spans) &&
+        wholeSectors(spans)) {
+        for (const auto &span : spans) {
+            const size_t count(span.second / SectorSize);
+            const size_t done = image.writeSectors(span.first, sector, count);
+            if (done != span.second) {
+                warn("Failed to write sectors %i-%i\n", sector,
+                     sector + count - 1);
+                return S_IOERR;
+            }
+            sector += count;
+        }
+        return S_OK;
+    }
+
+    std::vector<uint8_t> data(size);
 
     desc_chain->chainRead(off_data, &data[0], size);
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.write(&data[offset], sector) != SectorSize) {
-            warn("Failed to write sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    const size_t done = image.writeSectors(data.data(), sector,
+                                           size / SectorSize);
+    if (done != size) {
+        warn("Failed to write sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     return S_OK;
@@ -132,6 +132,13 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # Geometry of the set-associative array holding the tracked lines,
+    # the size is in terms of the cache lines it can track. Lines that
+    # don't fit go to an overflow map, so these only affect performance.
+    size = Param.MemorySize(Self.max_capacity,
+                            "Capacity of the snoop filter array")
+    assoc = Param.Unsigned(8, "Associativity of the snoop filter array")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
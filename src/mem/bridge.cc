@@ -346,6 +346,17 @@ Bridge::BridgeSlavePort::recvAtomic(PacketPtr pkt)
     return delay * bridge.clockPeriod() + masterPort.sendAtomic(pkt);
 }
 
+Tick
+Bridge::BridgeSlavePort::recvAtomicBackdoor(PacketPtr pkt,
+                                            MemBackdoorPtr &backdoor)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    return delay * bridge.clockPeriod() +
+        masterPort.sendAtomicBackdoor(pkt, backdoor);
+}
+
 void
 Bridge::BridgeSlavePort::recvFunctional(PacketPtr pkt)
 {
@@ -205,6 +205,10 @@ class Bridge : public ClockedObject
             pass it to the bridge. */
         Tick recvAtomic(PacketPtr pkt);
 
+        /** When receiving an Atomic request asking for a back door,
+            pass it to the bridge. */
+        Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
         /** When receiving a Functional request from the peer port,
             pass it to the bridge. */
         void recvFunctional(PacketPtr pkt);
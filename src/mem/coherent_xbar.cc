@@ -688,9 +688,10 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 }
 
 
+template <typename Ports>
 void
 CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
-                           const std::vector<QueuedSlavePort*>& dests)
+                            const Ports& dests)
 {
     DPRINTF(CoherentXBar, "%s for %s\n", __func__, pkt->print());
 
@@ -917,10 +918,11 @@ CoherentXBar::recvAtomicSnoop(PacketPtr pkt, PortID master_port_id)
     return snoop_response_latency;
 }
 
+template <typename Ports>
 std::pair<MemCmd, Tick>
 CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id,
-                           PortID source_master_port_id,
-                           const std::vector<QueuedSlavePort*>& dests)
+                            PortID source_master_port_id,
+                            const Ports& dests)
 {
     // the packet may be changed on snoops, record the original
     // command to enable us to restore it between snoops so that
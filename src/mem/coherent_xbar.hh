@@ -326,10 +326,12 @@ class CoherentXBar : public BaseXBar
      *
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt, either a
+     *              vector of ports or snoop filter targets
      */
+    template <typename Ports>
     void forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
-                       const std::vector<QueuedSlavePort*>& dests);
+                       const Ports& dests);
 
     Tick recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
                             MemBackdoorPtr *backdoor=nullptr);
@@ -360,15 +362,16 @@ class CoherentXBar : public BaseXBar
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
      * @param source_master_port_id Id of the master port for snoops from below
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt, either a
+     *              vector of ports or snoop filter targets
      *
      * @return a pair containing the snoop response and snoop latency
      */
+    template <typename Ports>
     std::pair<MemCmd, Tick> forwardAtomic(PacketPtr pkt,
                                           PortID exclude_slave_port_id,
                                           PortID source_master_port_id,
-                                          const std::vector<QueuedSlavePort*>&
-                                          dests);
+                                          const Ports& dests);
 
     /** Function called by the port when the crossbar is recieving a Functional
         transaction.*/
@@ -279,6 +279,16 @@ DRAMCtrl::recvAtomic(PacketPtr pkt)
     return latency;
 }
 
+Tick
+DRAMCtrl::recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor)
+{
+    Tick latency = recvAtomic(pkt);
+
+    if (backdoor.ptr())
+        _backdoor = &backdoor;
+    return latency;
+}
+
 bool
 DRAMCtrl::readQueueFull(unsigned int neededEntries) const
 {
@@ -2817,6 +2827,13 @@ DRAMCtrl::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+Tick
+DRAMCtrl::MemoryPort::recvAtomicBackdoor(PacketPtr pkt,
+                                         MemBackdoorPtr &backdoor)
+{
+    return memory.recvAtomicBackdoor(pkt, backdoor);
+}
+
 bool
 DRAMCtrl::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
@@ -84,6 +84,11 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     const bool expect_response = pkt->needsResponse() &&
         !pkt->cacheResponding();
 
+    // remember where to route the response to, this has to be done
+    // before sending as the route is carried by the packet
+    if (expect_response)
+        pushRoute(pkt, slave_port_id);
+
     // since it is a normal request, attempt to send the packet
     bool success = masterPorts[master_port_id]->sendTimingReq(pkt);
 
@@ -91,6 +96,9 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         DPRINTF(HMCController, "recvTimingReq: src %s %s 0x%x RETRY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
 
+        if (expect_response)
+            popRoute(pkt);
+
         // restore the header delay as it is additive
         pkt->headerDelay = old_header_delay;
 
@@ -101,12 +109,6 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         return false;
     }
 
-    // remember where to route the response to
-    if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = slave_port_id;
-    }
-
     reqLayers[master_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
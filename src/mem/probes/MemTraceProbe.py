@@ -46,6 +46,9 @@ class MemTraceProbe(BaseMemProbe):
     # Boolean to compress the trace or not.
     trace_compress = Param.Bool(True, "Enable trace compression")
 
+    # Compress and write the trace on a background thread
+    trace_async = Param.Bool(True, "Write the trace on a background thread")
+
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
 
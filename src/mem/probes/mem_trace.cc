@@ -72,7 +72,7 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
                                   (p->trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    traceStream = new ProtoOutputStream(filename, p->trace_async);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -99,11 +99,20 @@ MemTraceProbe::startup()
     traceStream->write(header_msg);
 }
 
+DrainState
+MemTraceProbe::drain()
+{
+    if (traceStream != NULL)
+        traceStream->flush();
+    return DrainState::Drained;
+}
+
 void
 MemTraceProbe::closeStreams()
 {
     if (traceStream != NULL)
         delete traceStream;
+    traceStream = NULL;
 }
 
 void
@@ -63,6 +63,9 @@ class MemTraceProbe : public BaseMemProbe
 
     void startup() override;
 
+    /** Write out all buffered trace records. */
+    DrainState drain() override;
+
   protected:
 
     /** Trace output stream */
@@ -70,6 +70,9 @@ class Consumer
 
     void scheduleEventAbsolute(Tick timeAbs);
 
+    //! Event queue the consumer's wakeups are serviced on
+    EventQueue *eventQueue() const { return em->eventQueue(); }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
@@ -149,15 +149,6 @@ random_time()
 void
 MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 {
-    // record current time incase we have a pop that also adjusts my size
-    if (m_time_last_time_enqueue < current_time) {
-        m_msgs_this_cycle = 0;  // first msg this cycle
-        m_time_last_time_enqueue = current_time;
-    }
-
-    m_msg_counter++;
-    m_msgs_this_cycle++;
-
     // Calculate the arrival time of the message, that is, the first
     // cycle the message can be dequeued.
     assert(delta > 0);
@@ -205,31 +196,97 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 
     msg_ptr->updateDelayedTicks(current_time);
     msg_ptr->setLastEnqueueTime(arrival_time);
+
+    assert(m_consumer != NULL);
+    if (crossesEventQueues()) {
+        deliverAcrossEventQueues(std::move(message), arrival_time);
+        return;
+    }
+
+    insertMessage(std::move(message), current_time, arrival_time);
+}
+
+void
+MessageBuffer::insertMessage(MsgPtr message, Tick current_time,
+                             Tick arrival_time)
+{
+    // record current time incase we have a pop that also adjusts my size
+    if (m_time_last_time_enqueue < current_time) {
+        m_msgs_this_cycle = 0;  // first msg this cycle
+        m_time_last_time_enqueue = current_time;
+    }
+
+    m_msg_counter++;
+    m_msgs_this_cycle++;
+
+    Message *msg_ptr = message.get();
     msg_ptr->setMsgCounter(m_msg_counter);
 
     // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
+    m_prio_heap.push_back(std::move(message));
     push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
     // Increment the number of messages statistic
     m_buf_msgs++;
 
     DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
-            arrival_time, *(message.get()));
+            arrival_time, *msg_ptr);
 
     // Schedule the wakeup
-    assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+bool
+MessageBuffer::crossesEventQueues() const
+{
+    return numMainEventQueues > 1 &&
+        curEventQueue() != m_consumer->eventQueue();
+}
+
+void
+MessageBuffer::deliverAcrossEventQueues(MsgPtr message, Tick arrival_time)
+{
+    // The consumer may be anywhere inside the current quantum, so the
+    // message can only be handed over if it arrives no earlier than
+    // the next global synchronization point. The latency of the
+    // crossing therefore acts as the lookahead of the partition.
+    if (arrival_time < curTick() + simQuantum) {
+        panic("%s: message crosses event queues with latency %d, which "
+              "is below the simulation quantum (%d). Reduce sim_quantum "
+              "or increase the latency of this buffer's producer.\n",
+              name(), arrival_time - curTick(), simQuantum);
+    }
+
+    // Producers check for free slots from their own thread, which
+    // would race with the consumer popping messages.
+    if (m_max_size != 0) {
+        fatal("%s: finite-sized buffers cannot cross event queues.\n",
+              name());
+    }
+
+    // The heap and the consumer's wakeup bookkeeping are only ever
+    // touched from the consumer's thread. The message is therefore
+    // handed over through an asynchronous event on the consumer's
+    // queue that is serviced before the consumer wakes up.
+    DPRINTF(RubyQueue, "Cross-queue enqueue arrival_time: %lld, "
+            "Message: %s\n", arrival_time, *(message.get()));
+
+    auto *evt = new EventFunctionWrapper(
+        [this, message, arrival_time]{
+            insertMessage(message, curTick(), arrival_time);
+        }, "MessageBuffer cross-queue delivery", true,
+        Event::Delayed_Writeback_Pri);
+    m_consumer->eventQueue()->schedule(evt, arrival_time, true);
+}
+
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
     DPRINTF(RubyQueue, "Popping\n");
     assert(isReady(current_time));
 
-    // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    // get the message about to be dequeued
+    Message *message = m_prio_heap.front().get();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -291,13 +348,11 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
     pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
 
     Tick future_time = current_time + recycle_latency;
-    node->setLastEnqueueTime(future_time);
+    m_prio_heap.back()->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
     push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
     m_consumer->scheduleEventAbsolute(future_time);
 }
@@ -306,17 +361,17 @@ void
 MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
 {
     while (!lt.empty()) {
-        MsgPtr m = lt.front();
+        Message *m = lt.front().get();
         assert(m->getLastEnqueueTime() <= schdTick);
 
-        m_prio_heap.push_back(m);
+        m_prio_heap.push_back(std::move(lt.front()));
         push_heap(m_prio_heap.begin(), m_prio_heap.end(),
                   greater<MsgPtr>());
 
         m_consumer->scheduleEventAbsolute(schdTick);
 
         DPRINTF(RubyQueue, "Requeue arrival_time: %lld, Message: %s\n",
-            schdTick, *(m.get()));
+            schdTick, *m);
 
         lt.pop_front();
     }
@@ -377,7 +432,7 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     // Instead the controller is responsible to call reanalyzeMessages when
     // these addresses change state.
     //
-    (m_stall_msg_map[addr]).push_back(message);
+    (m_stall_msg_map[addr]).push_back(std::move(message));
     m_stall_map_size++;
     m_stall_count++;
 }
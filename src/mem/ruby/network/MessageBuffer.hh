@@ -39,6 +39,7 @@
 #include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/trace.hh"
@@ -68,11 +69,11 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
         std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
                       std::greater<MsgPtr>());
+        MsgPtr m = std::move(m_prio_heap.back());
         m_prio_heap.pop_back();
-        enqueue(m, current_time, delta);
+        enqueue(std::move(m), current_time, delta);
     }
 
     bool areNSlotsAvailable(unsigned int n, Tick curTime);
@@ -139,6 +140,28 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    //! Pushes a message whose arrival time has already been computed
+    //! onto the heap and wakes up the consumer.
+    void insertMessage(MsgPtr message, Tick current_time,
+                       Tick arrival_time);
+
+    /**
+     * Check whether the calling thread services a different event
+     * queue than the consumer of this buffer. This is the case when
+     * Ruby controllers and network components are partitioned across
+     * several event queues and this buffer sits on a partition
+     * boundary.
+     */
+    bool crossesEventQueues() const;
+
+    /**
+     * Hand a message over to a consumer running on another event
+     * queue. The arrival time must not be earlier than the next
+     * global synchronization point (i.e., the buffer's latency must
+     * cover the simulation quantum).
+     */
+    void deliverAcrossEventQueues(MsgPtr message, Tick arrival_time);
+
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
@@ -109,6 +109,21 @@ class AbstractController : public ClockedObject, public Consumer
     virtual Cycles mandatoryQueueLatency(const RubyRequestType& param_type)
     { return m_mandatory_queue_latency; }
 
+    //! Functions used by RubySystem to restore cache state from a
+    //! checkpoint without replaying the trace through the protocol.
+    //! A protocol opts in by defining both functions in each of its
+    //! machines. warmupLine() is first called on the controller that
+    //! recorded the line (requestor == this controller); it returns true
+    //! if the line was installed, in which case it is then called on all
+    //! other controllers so that they can update their own state (e.g.
+    //! the home directory recording the owner).
+    virtual bool supportsFastWarmup() { return false; }
+    virtual bool warmupLine(const MachineID& param_requestor,
+                            const Addr& param_addr,
+                            const RubyRequestType& param_type,
+                            const DataBlock& param_data)
+    { return false; }
+
     //! These functions are used by ruby system to read/write the data blocks
     //! that exist with in the controller.
     virtual void functionalRead(const Addr &addr, PacketPtr) = 0;
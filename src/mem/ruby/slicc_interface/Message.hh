@@ -30,34 +30,113 @@
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
 #include <iostream>
-#include <memory>
+#include <new>
 #include <stack>
+#include <vector>
 
+#include "base/refcnt.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/protocol/MessageSizeType.hh"
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
+typedef RefCountingPtr<Message> MsgPtr;
 
+/**
+ * Recycles the storage of one message type through a per-thread free
+ * list, so that steady-state message traffic does not hit the host
+ * allocator. Message types opt in by forwarding their class-specific
+ * operator new/delete here.
+ *
+ * A message handed to another event queue is freed by a different
+ * thread than the one that allocated it, so a thread can keep
+ * receiving more blocks than it allocates. The free list is capped
+ * and the surplus goes back to the host allocator.
+ */
+template <class T>
+class MessageAllocator
+{
+  public:
+    static void *
+    allocate(size_t size)
+    {
+        std::vector<void *> &free_list = freeList().blocks;
+        if (size != sizeof(T) || free_list.empty())
+            return ::operator new(size);
+
+        void *p = free_list.back();
+        free_list.pop_back();
+        return p;
+    }
+
+    static void
+    release(void *p, size_t size)
+    {
+        std::vector<void *> &free_list = freeList().blocks;
+        if (size != sizeof(T) || free_list.size() >= maxFreeBlocks)
+            ::operator delete(p);
+        else
+            free_list.push_back(p);
+    }
+
+  private:
+    /** Maximum number of blocks kept per thread */
+    static const size_t maxFreeBlocks = 4096;
+
+    struct FreeList
+    {
+        std::vector<void *> blocks;
+
+        ~FreeList()
+        {
+            for (auto p : blocks)
+                ::operator delete(p);
+        }
+    };
+
+    static FreeList &
+    freeList()
+    {
+        static thread_local FreeList free_list;
+        return free_list;
+    }
+};
+
+/**
+ * Base class of all Ruby messages. Messages are reference counted
+ * through MsgPtr with a non-atomic count: a message is only shared by
+ * objects on the same event queue, or handed to another queue at a
+ * quantum boundary (see MessageBuffer), so it is never referenced from
+ * two threads at the same time.
+ */
 class Message
 {
   public:
     Message(Tick curTime)
         : m_time(curTime),
           m_LastEnqueueTime(curTime),
-          m_DelayedTicks(0), m_msg_counter(0)
+          m_DelayedTicks(0), m_msg_counter(0), m_ref_count(0)
     { }
 
     Message(const Message &other)
         : m_time(other.m_time),
           m_LastEnqueueTime(other.m_LastEnqueueTime),
           m_DelayedTicks(other.m_DelayedTicks),
-          m_msg_counter(other.m_msg_counter)
+          m_msg_counter(other.m_msg_counter), m_ref_count(0)
     { }
 
+    // Assigning would either copy the reference count of the source
+    // or have to leave it out; messages are cloned instead.
+    Message &operator=(const Message &other) = delete;
+
     virtual ~Message() { }
 
+    /** Reference counting interface used by MsgPtr. */
+    /** @{ */
+    void incref() const { ++m_ref_count; }
+    void decref() const { if (--m_ref_count <= 0) delete this; }
+    /** @} */
+
     virtual MsgPtr clone() const = 0;
     virtual void print(std::ostream& out) const = 0;
 
@@ -112,6 +191,10 @@ class Message
     // Variables for required network traversal
     int incoming_link;
     int vnet;
+
+    // Number of MsgPtrs referencing this message. It is not copied
+    // along with the message.
+    mutable int m_ref_count;
 };
 
 inline bool
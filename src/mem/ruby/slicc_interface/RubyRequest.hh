@@ -142,7 +142,19 @@ class RubyRequest : public Message
 
     RubyRequest(Tick curTime) : Message(curTime) {}
     MsgPtr clone() const
-    { return std::shared_ptr<Message>(new RubyRequest(*this)); }
+    { return new RubyRequest(*this); }
+
+    static void *
+    operator new(size_t size)
+    {
+        return MessageAllocator<RubyRequest>::allocate(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        MessageAllocator<RubyRequest>::release(p, size);
+    }
 
     Addr getLineAddress() const { return m_LineAddress; }
     Addr getPhysicalAddress() const { return m_PhysicalAddress; }
@@ -31,7 +31,6 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -167,9 +166,16 @@ class CacheMemory : public SimObject
 
     // The first index is the # of cache lines.
     // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
     std::vector<std::vector<AbstractCacheEntry*> > m_cache;
 
+    /**
+     * Line address held by each way, stored contiguously set after set
+     * (m_cache_assoc entries per set) so that a tag lookup only scans
+     * the few cache lines holding its set. Ways without an allocated
+     * entry hold MaxAddr, which can never match a line address.
+     */
+    std::vector<Addr> m_tags;
+
     /**
      * We use BaseReplacementPolicy from Classic system here, hence we can use
      * different replacement policies from Classic system in Ruby system.
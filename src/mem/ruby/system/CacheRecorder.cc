@@ -30,6 +30,7 @@
 #include "mem/ruby/system/CacheRecorder.hh"
 
 #include "debug/RubyCacheTrace.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
@@ -148,6 +149,53 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+void
+CacheRecorder::installRecords(const std::vector<AbstractController*>& cntrls)
+{
+    uint64_t installed = 0;
+    uint64_t dropped = 0;
+
+    while (m_bytes_read < m_uncompressed_trace_size) {
+        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                                                m_bytes_read);
+
+        DPRINTF(RubyCacheTrace, "Installing %s\n", *traceRecord);
+
+        AbstractController *requestor = cntrls[traceRecord->m_cntrl_id];
+        MachineID requestor_id = requestor->getMachineID();
+
+        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+            Addr addr = traceRecord->m_data_address + rec_bytes_read;
+            DataBlock data;
+            data.setData(traceRecord->m_data + rec_bytes_read, 0,
+                         RubySystem::getBlockSizeBytes());
+
+            // The requestor decides whether the line fits; the other
+            // controllers only learn about lines that were installed so
+            // that the global state stays coherent.
+            if (!requestor->warmupLine(requestor_id, addr,
+                                       traceRecord->m_type, data)) {
+                dropped++;
+                continue;
+            }
+            for (auto cntrl : cntrls) {
+                if (cntrl != requestor) {
+                    cntrl->warmupLine(requestor_id, addr,
+                                      traceRecord->m_type, data);
+                }
+            }
+            installed++;
+        }
+
+        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
+        m_records_read++;
+    }
+
+    DPRINTF(RubyCacheTrace, "Installed %d lines from %d records, "
+            "dropped %d\n", installed, m_records_read, dropped);
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
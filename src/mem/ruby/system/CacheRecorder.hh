@@ -43,6 +43,7 @@
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
 
+class AbstractController;
 class Sequencer;
 
 /*!
@@ -97,6 +98,14 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for warming up the caches without going through the
+     * protocol. Each recorded line is handed to the controllers'
+     * warmupLine() hook, which installs it directly in a stable state.
+     * Only usable if every controller supports fast warmup.
+     */
+    void installRecords(const std::vector<AbstractController*>& cntrls);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
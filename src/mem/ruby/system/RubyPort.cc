@@ -48,9 +48,56 @@
 #include "mem/ruby/protocol/AccessPermission.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/simple_mem.hh"
+#include "sim/eventq.hh"
 #include "sim/full_system.hh"
 #include "sim/system.hh"
 
+namespace {
+
+/**
+ * Stop all event queues for the duration of a functional access.
+ *
+ * Functional accesses walk the caches and buffers of every
+ * controller, which may be running in other threads when the
+ * controllers are partitioned across event queues. The current queue
+ * is released before the locks of all queues are taken in order, so
+ * that concurrent functional accesses from different threads can't
+ * deadlock. Other threads only hold their own queue lock while
+ * servicing an event, so the access waits for their current events
+ * to finish. This makes the timing of the access relative to the
+ * other queues non-deterministic.
+ */
+class ScopedEventQueuesLock
+{
+  public:
+    ScopedEventQueuesLock()
+        : locked(inParallelMode)
+    {
+        if (!locked)
+            return;
+
+        curEventQueue()->unlock();
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            mainEventQueue[i]->lock();
+    }
+
+    ~ScopedEventQueuesLock()
+    {
+        if (!locked)
+            return;
+
+        for (uint32_t i = numMainEventQueues; i > 0; --i)
+            mainEventQueue[i - 1]->unlock();
+        curEventQueue()->lock();
+    }
+
+  private:
+    /** Were other threads running when the access started? */
+    const bool locked;
+};
+
+} // anonymous namespace
+
 RubyPort::RubyPort(const Params *p)
     : ClockedObject(p), m_ruby_system(p->ruby_system), m_version(p->version),
       m_controller(NULL), m_mandatory_q_ptr(NULL),
@@ -362,6 +409,8 @@ RubyPort::MemSlavePort::recvFunctional(PacketPtr pkt)
 {
     DPRINTF(RubyPort, "Functional access for address: %#x\n", pkt->getAddr());
 
+    ScopedEventQueuesLock lock;
+
     RubyPort *rp M5_VAR_USED = static_cast<RubyPort *>(&owner);
     RubySystem *rs = rp->m_ruby_system;
 
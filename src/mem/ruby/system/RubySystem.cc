@@ -58,7 +58,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
-      m_cache_recorder(NULL)
+      m_fast_warmup(p->fast_warmup), m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
 
@@ -348,7 +348,19 @@ RubySystem::startup()
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
 
-    if (m_warmup_enabled) {
+    if (m_warmup_enabled && m_fast_warmup && fastWarmupSupported()) {
+        // The protocol knows how to install recorded lines directly, so
+        // no requests need to be simulated and time does not move.
+        DPRINTF(RubyCacheTrace, "Starting fast ruby cache warmup\n");
+        m_cache_recorder->installRecords(m_abs_cntrl_vec);
+
+        delete m_cache_recorder;
+        m_cache_recorder = NULL;
+        m_systems_to_warmup--;
+        if (m_systems_to_warmup == 0) {
+            m_warmup_enabled = false;
+        }
+    } else if (m_warmup_enabled) {
         DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
         // save the current tick value
         Tick curtick_original = curTick();
@@ -379,6 +391,19 @@ RubySystem::startup()
     resetStats();
 }
 
+bool
+RubySystem::fastWarmupSupported() const
+{
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (!cntrl->supportsFastWarmup()) {
+            warn("%s does not support fast cache warmup, replaying the "
+                 "cache trace instead\n", cntrl->name());
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 RubySystem::processRubyEvent()
 {
@@ -118,6 +118,8 @@ class RubySystem : public ClockedObject
 
     void processRubyEvent();
   private:
+    bool fastWarmupSupported() const;
+
     // configuration parameters
     static bool m_randomization;
     static uint32_t m_block_size_bytes;
@@ -129,6 +131,7 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_fast_warmup;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
@@ -48,6 +48,10 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    fast_warmup = Param.Bool(False, "Restore cache contents from a \
+        checkpoint by installing lines directly instead of replaying the \
+        cache trace through the protocol (requires protocol support)")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
@@ -55,8 +55,8 @@ class EnqueueStatementAST(StatementAST):
         self.symtab.newSymbol(v)
 
         # Declare message
-        code("std::shared_ptr<${{msg_type.c_ident}}> out_msg = "\
-             "std::make_shared<${{msg_type.c_ident}}>(clockEdge());")
+        code("RefCountingPtr<${{msg_type.c_ident}}> out_msg = "\
+             "new ${{msg_type.c_ident}}(clockEdge());")
 
         # The other statements
         t = self.statements.generate(code, None)
@@ -65,9 +65,10 @@ class EnqueueStatementAST(StatementAST):
         if self.latexpr != None:
             ret_type, rcode = self.latexpr.inline(True)
             code("(${{self.queue_name.var.code}}).enqueue(" \
-                 "out_msg, clockEdge(), cyclesToTicks(Cycles($rcode)));")
+                 "std::move(out_msg), clockEdge(), " \
+                 "cyclesToTicks(Cycles($rcode)));")
         else:
-            code("(${{self.queue_name.var.code}}).enqueue(out_msg, "\
+            code("(${{self.queue_name.var.code}}).enqueue(std::move(out_msg), "\
                  "clockEdge(), cyclesToTicks(Cycles(1)));")
 
         # End scope
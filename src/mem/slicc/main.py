@@ -71,6 +71,9 @@ def main(args=None):
                       help="Print files that SLICC will generate")
     parser.add_option("--tb", "--traceback", action='store_true',
                       help="print traceback on error")
+    parser.add_option("--table-dispatch", action='store_true',
+                      help="dispatch transitions through a (state, event) "
+                           "table instead of a switch statement")
     parser.add_option("-q", "--quiet",
                       help="don't print messages")
     opts,files = parser.parse_args(args=args)
@@ -93,7 +96,7 @@ def main(args=None):
     protocol_base = os.path.join(os.path.dirname(__file__),
                                  '..', 'ruby', 'protocol')
     slicc = SLICC(slicc_file, protocol_base, verbose=True, debug=opts.debug,
-                  traceback=opts.tb)
+                  traceback=opts.tb, table_dispatch=opts.table_dispatch)
 
 
     if opts.print_files:
@@ -93,6 +93,7 @@ class StateMachine(Symbol):
         self.TBEType   = None
         self.EntryType = None
         self.debug_flags = set()
+        self.debug_flags.add('ProtocolTrace')
         self.debug_flags.add('RubyGenerated')
         self.debug_flags.add('RubySlicc')
 
@@ -268,6 +269,7 @@ class $py_ident(RubyController):
 #ifndef __${ident}_CONTROLLER_HH__
 #define __${ident}_CONTROLLER_HH__
 
+#include <array>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -363,7 +365,12 @@ TransitionResult doTransitionWorker(${ident}_Event event,
 
         code('''
                                     Addr addr);
+''')
+
+        if self.symtab.slicc.table_dispatch:
+            self.printTransitionTableDecls(code)
 
+        code('''
 int m_counters[${ident}_State_NUM][${ident}_Event_NUM];
 int m_event_counters[${ident}_Event_NUM];
 bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
@@ -436,6 +443,222 @@ void unset_tbe(${{self.TBEType.c_ident}}*& m_tbe_ptr);
         code('#endif // __${ident}_CONTROLLER_H__')
         code.write(path, '%s.hh' % c_ident)
 
+    def actionParams(self):
+        '''Formal parameters shared by all actions of this machine'''
+        params = []
+        if self.TBEType != None:
+            params.append('%s*& m_tbe_ptr' % self.TBEType.c_ident)
+        if self.EntryType != None:
+            params.append('%s*& m_cache_entry_ptr' % self.EntryType.c_ident)
+        params.append('Addr addr')
+        return params
+
+    def printTransitionTableDecls(self, code):
+        '''Declarations used by the table-driven transition dispatch'''
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+        types = [ p.rsplit(' ', 1)[0] for p in self.actionParams() ]
+
+        code('''
+typedef void (${c_ident}::*TransitionAction)(${{', '.join(types)}});
+
+/**
+ * A unique transition body. Transitions sharing next state, resource
+ * checks and action sequence are folded into one block.
+ */
+struct TransitionBlock
+{
+    enum NextState : uint8_t { Keep, Fixed, Wildcard };
+
+    //! How next_state is determined by the transition
+    NextState nextStateKind;
+    //! Next state if nextStateKind is Fixed
+    ${ident}_State nextState;
+    //! Case in checkTransitionResources(), -1 if nothing to check
+    int16_t resourceCheck;
+    //! Whether the transition stalls the incoming message
+    bool stall;
+    //! Range of the block's actions in s_transition_actions
+    uint16_t firstAction;
+    uint16_t numActions;
+};
+
+//! Block index for each (state, event) pair, -1 if invalid
+static const std::array<int16_t, ${ident}_State_NUM * ${ident}_Event_NUM>
+    s_transition_block;
+static const TransitionBlock s_transition_blocks[];
+static const TransitionAction s_transition_actions[];
+
+TransitionResult checkTransitionResources(int check, Addr addr);
+''')
+
+    def printTransitionTableWorker(self, code):
+        '''Table-driven doTransitionWorker() and its tables'''
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+
+        blocks = OrderedDict()
+        checks = OrderedDict()
+        entries = []
+        wildcard = False
+
+        for trans in self.transitions:
+            if trans.state == trans.nextState:
+                next_state = ('Keep', '%s_State_%s' % (ident, trans.state.ident))
+            elif trans.nextState.isWildcard():
+                next_state = ('Wildcard', '%s_State_%s' % (ident, trans.state.ident))
+                wildcard = True
+            else:
+                next_state = ('Fixed', '%s_State_%s' % \
+                              (ident, trans.nextState.ident))
+
+            check = self.symtab.codeFormatter()
+            case_sorter = []
+            for key,val in trans.resources.iteritems():
+                case_sorter.append('''
+if (!%s.areNSlotsAvailable(%s, clockEdge()))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val))
+            for request_type in trans.request_types:
+                case_sorter.append('''
+if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    return TransitionResult_ResourceStall;
+}
+''' % (ident, request_type.ident))
+            for c in sorted(case_sorter):
+                check("$c")
+            for request_type in trans.request_types:
+                check('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+            check = str(check)
+
+            check_idx = -1
+            if check:
+                if check not in checks:
+                    checks[check] = len(checks)
+                check_idx = checks[check]
+
+            stall = any(a.ident == "z_stall" for a in trans.actions)
+            actions = () if stall else \
+                tuple(a.ident for a in trans.actions)
+
+            key = (next_state, check_idx, stall, actions)
+            if key not in blocks:
+                blocks[key] = len(blocks)
+
+            entries.append((trans, blocks[key]))
+
+        code('''
+const std::array<int16_t, ${ident}_State_NUM * ${ident}_Event_NUM>
+${c_ident}::s_transition_block = [] {
+    std::array<int16_t, ${ident}_State_NUM * ${ident}_Event_NUM> table;
+    table.fill(-1);
+''')
+        code.indent()
+        for trans,idx in entries:
+            code('table[HASH_FUN(${ident}_State_${{trans.state.ident}}, '
+                 '${ident}_Event_${{trans.event.ident}})] = $idx;')
+        code('''
+return table;
+''')
+        code.dedent()
+        code('''
+}();
+
+const ${c_ident}::TransitionBlock ${c_ident}::s_transition_blocks[] = {
+''')
+        code.indent()
+        first_action = 0
+        for (next_state,check_idx,stall,actions) in blocks:
+            kind, state = next_state
+            code('{ TransitionBlock::$kind, $state, $check_idx, '
+                 '${{"true" if stall else "false"}}, $first_action, '
+                 '${{len(actions)}} },')
+            first_action += len(actions)
+        code.dedent()
+        code('''
+};
+
+const ${c_ident}::TransitionAction ${c_ident}::s_transition_actions[] = {
+''')
+        code.indent()
+        for (next_state,check_idx,stall,actions) in blocks:
+            for action in actions:
+                code('&${c_ident}::${action},')
+        code('nullptr')
+        code.dedent()
+        code('''
+};
+
+TransitionResult
+${c_ident}::checkTransitionResources(int check, Addr addr)
+{
+    switch (check) {
+''')
+        for check,idx in checks.iteritems():
+            code('  case $idx:')
+            code('    $check')
+            code('    break;\n')
+        code('''
+      default:
+        panic("Invalid resource check %d\\n", check);
+    }
+
+    return TransitionResult_Valid;
+}
+
+TransitionResult
+${c_ident}::doTransitionWorker(${ident}_Event event,
+                               ${ident}_State state,
+                               ${ident}_State& next_state,
+                               ${{', '.join(self.actionParams())}})
+{
+    const int16_t idx = s_transition_block[HASH_FUN(state, event)];
+    if (idx < 0) {
+        panic("Invalid transition\\n"
+              "%s time: %d addr: %#x event: %s state: %s\\n",
+              name(), curCycle(), addr, event, state);
+    }
+
+    const TransitionBlock &block = s_transition_blocks[idx];
+''')
+        code.indent()
+        if wildcard:
+            code('''
+if (block.nextStateKind == TransitionBlock::Fixed)
+    next_state = block.nextState;
+else if (block.nextStateKind == TransitionBlock::Wildcard)
+    next_state = getNextState(addr);
+''')
+        else:
+            code('''
+if (block.nextStateKind == TransitionBlock::Fixed)
+    next_state = block.nextState;
+''')
+        args = [ 'm_tbe_ptr' ] if self.TBEType != None else []
+        if self.EntryType != None:
+            args.append('m_cache_entry_ptr')
+        args.append('addr')
+        code('''
+
+if (block.resourceCheck >= 0) {
+    TransitionResult result =
+        checkTransitionResources(block.resourceCheck, addr);
+    if (result != TransitionResult_Valid)
+        return result;
+}
+
+if (block.stall)
+    return TransitionResult_ProtocolStall;
+
+const TransitionAction *actions = &s_transition_actions[block.firstAction];
+for (int i = 0; i < block.numActions; ++i)
+    (this->*actions[i])(${{', '.join(args)}});
+
+return TransitionResult_Valid;
+''')
+        code.dedent()
+        code('}')
+
     def printControllerCC(self, path, includes):
         '''Output the actions for performing the actions'''
 
@@ -505,8 +728,12 @@ std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
 
+// The comment is only ever printed by the protocol trace, so avoid
+// formatting it into the stream when the trace is disabled
 #ifndef NDEBUG
-#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#define APPEND_TRANSITION_COMMENT(str) \\
+    (DTRACE(ProtocolTrace) ? (void)(${ident}_transitionComment << str) \\
+                           : (void)0)
 #else
 #define APPEND_TRANSITION_COMMENT(str) do {} while (0)
 #endif
@@ -1243,7 +1470,8 @@ if (result == TransitionResult_Valid) {
              ${ident}_State_to_string(next_state),
              printAddress(addr), GET_TRANSITION_COMMENT());
 
-    CLEAR_TRANSITION_COMMENT();
+    if (DTRACE(ProtocolTrace))
+        CLEAR_TRANSITION_COMMENT();
 ''')
         if self.TBEType != None and self.EntryType != None:
             code('setState(m_tbe_ptr, m_cache_entry_ptr, addr, next_state);')
@@ -1281,7 +1509,14 @@ return result;
         code.dedent()
         code('''
 }
+''')
 
+        if self.symtab.slicc.table_dispatch:
+            self.printTransitionTableWorker(code)
+            code.write(path, "%s_Transitions.cc" % self.ident)
+            return
+
+        code('''
 TransitionResult
 ${ident}_Controller::doTransitionWorker(${ident}_Event event,
                                         ${ident}_State state,
@@ -263,8 +263,12 @@ $klass ${{self.c_ident}}$parent
 
         # ******** Assignment operator ********
 
+        # Messages are reference counted and can't be assigned
         code('${{self.c_ident}}')
-        code('&operator=(const ${{self.c_ident}}&) = default;')
+        if self.isMessage:
+            code('&operator=(const ${{self.c_ident}}&) = delete;')
+        else:
+            code('&operator=(const ${{self.c_ident}}&) = default;')
 
         # ******** Full init constructor ********
         if not self.isGlobal:
@@ -298,7 +302,19 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return new ${{self.c_ident}}(*this);
+}
+
+static void *
+operator new(size_t size)
+{
+    return MessageAllocator<${{self.c_ident}}>::allocate(size);
+}
+
+static void
+operator delete(void *p, size_t size)
+{
+    MessageAllocator<${{self.c_ident}}>::release(p, size);
 }
 ''')
         else:
@@ -44,6 +44,7 @@
 
 #include "mem/snoop_filter.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -51,18 +52,120 @@
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p),
+      assoc(p->assoc),
+      setMask(p->size / p->system->cacheLineSize() / p->assoc - 1),
+      numValid(0), useCount(0),
+      linesize(p->system->cacheLineSize()),
+      lineShift(floorLog2(p->system->cacheLineSize())),
+      lookupLatency(p->lookup_latency),
+      maxEntryCount(p->max_capacity / p->system->cacheLineSize())
+{
+    const unsigned num_sets = p->size / linesize / assoc;
+    fatal_if(assoc == 0, "%s: associativity must be non-zero\n", name());
+    fatal_if(num_sets == 0 || !isPowerOf2(num_sets),
+             "%s: size / line size / assoc must be a power of 2, got %d\n",
+             name(), num_sets);
+
+    entries.resize(num_sets * assoc, SnoopEntry{ MaxAddr, 0, {0, 0} });
+}
+
+SnoopFilter::SnoopEntry *
+SnoopFilter::findEntry(Addr line_addr)
+{
+    SnoopEntry *set = &entries[((line_addr >> lineShift) & setMask) * assoc];
+    for (unsigned way = 0; way < assoc; ++way) {
+        if (set[way].addr == line_addr) {
+            set[way].lastUse = ++useCount;
+            return &set[way];
+        }
+    }
+
+    if (overflow.empty())
+        return nullptr;
+
+    auto it = overflow.find(line_addr);
+    if (it == overflow.end())
+        return nullptr;
+
+    // Move the line back into the array if a way has been freed up
+    // since it overflowed. A pending request may still refer to the
+    // entry, in which case it stays put.
+    if (&it->second != reqLookupResult.entry) {
+        for (unsigned way = 0; way < assoc; ++way) {
+            if (set[way].addr == MaxAddr) {
+                DPRINTF(SnoopFilter, "%s:   Moving SF entry %#x back from "
+                        "overflow.\n", __func__, line_addr);
+                set[way] = it->second;
+                set[way].lastUse = ++useCount;
+                overflow.erase(it);
+                numValid++;
+                return &set[way];
+            }
+        }
+    }
+    return &it->second;
+}
+
+SnoopFilter::SnoopEntry *
+SnoopFilter::allocateEntry(Addr line_addr)
+{
+    SnoopEntry *set = &entries[((line_addr >> lineShift) & setMask) * assoc];
+    SnoopEntry *victim = nullptr;
+    for (unsigned way = 0; way < assoc; ++way) {
+        if (set[way].addr == MaxAddr) {
+            victim = &set[way];
+            break;
+        }
+        // Lines with outstanding requests stay in place, the crossbar
+        // may still have to revert them.
+        if (set[way].item.requested.none() &&
+            &set[way] != reqLookupResult.entry &&
+            (!victim || set[way].lastUse < victim->lastUse)) {
+            victim = &set[way];
+        }
+    }
+
+    if (!victim) {
+        overflows++;
+        SnoopEntry &entry = overflow[line_addr];
+        entry = SnoopEntry{ line_addr, 0, {0, 0} };
+        return &entry;
+    }
+
+    if (victim->addr != MaxAddr) {
+        DPRINTF(SnoopFilter, "%s:   Moving SF entry %#x to overflow.\n",
+                __func__, victim->addr);
+        overflows++;
+        overflow.emplace(victim->addr, *victim);
+    } else {
+        numValid++;
+    }
+
+    *victim = SnoopEntry{ line_addr, ++useCount, {0, 0} };
+    return victim;
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(SnoopEntry *entry)
 {
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = entry->item;
     if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+        auto it = overflow.empty() ? overflow.end() :
+            overflow.find(entry->addr);
+        if (it != overflow.end() && &it->second == entry) {
+            overflow.erase(it);
+        } else {
+            entry->addr = MaxAddr;
+            numValid--;
+        }
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+std::pair<SnoopFilter::SnoopTargets, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
     DPRINTF(SnoopFilter, "%s: src %s packet %s\n", __func__,
@@ -76,8 +179,8 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(slave_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.entry = findEntry(line_addr);
+    bool is_hit = (reqLookupResult.entry != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,10 +190,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     // If no hit in snoop filter create a new element and update iterator
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.entry = allocateEntry(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = reqLookupResult.entry->item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -111,8 +213,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     // If we are not allocating, we are done
     if (!allocate)
-        return snoopSelected(maskToPortList(interested & ~req_port),
-                             lookupLatency);
+        return snoopSelected(interested & ~req_port, lookupLatency);
 
     if (cpkt->needsResponse()) {
         if (!cpkt->cacheResponding()) {
@@ -151,36 +252,37 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         }
     }
 
-    return snoopSelected(maskToPortList(interested & ~req_port), lookupLatency);
+    return snoopSelected(interested & ~req_port, lookupLatency);
 }
 
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.entry) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.entry->addr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            reqLookupResult.entry->item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(reqLookupResult.entry);
+        reqLookupResult.entry = nullptr;
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+std::pair<SnoopFilter::SnoopTargets, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
     DPRINTF(SnoopFilter, "%s: packet %s\n", __func__, cpkt->print());
@@ -191,10 +293,10 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopEntry *entry = findEntry(line_addr);
+    bool is_hit = (entry != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!is_hit && (numEntries() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -204,7 +306,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = entry->item;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -234,10 +336,10 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(entry);
     }
 
-    return snoopSelected(maskToPortList(interested), lookupLatency);
+    return snoopSelected(interested, lookupLatency);
 }
 
 void
@@ -264,7 +366,9 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopEntry *entry = findEntry(line_addr);
+    panic_if(!entry, "SF has no entry for %#x\n", line_addr);
+    SnoopItem& sf_item = entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -311,18 +415,17 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopEntry *entry = findEntry(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!entry)
         return;
 
     // If the snoop response has no sharers the line is passed in
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = entry->item;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -330,7 +433,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(entry);
     }
 }
 
@@ -352,12 +455,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopEntry *entry = findEntry(line_addr);
+    if (!entry)
         return;
 
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -376,7 +479,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~slave_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(entry);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -419,6 +522,11 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    overflows
+        .name(name() + ".overflows")
+        .desc("Number of lines moved to the overflow map because their "\
+              "set was full.");
 }
 
 SnoopFilter *
@@ -48,6 +48,7 @@
 #include <bitset>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -84,6 +85,15 @@
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * The tracked lines are kept in a set-associative array with LRU
+ * replacement, indexed by line address. The filter has to stay precise
+ * and there is no way to back-invalidate the holders of a line, so
+ * lines that don't fit in their set are moved to an overflow map. The
+ * map is only a fallback for sets that run out of ways: lines move
+ * back into the array when a way frees up, and the total number of
+ * lines is still bounded by the maximum capacity. The overflows are
+ * counted to help size the array.
  */
 class SnoopFilter : public SimObject {
   public:
@@ -93,12 +103,101 @@ class SnoopFilter : public SimObject {
 
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
+    /**
+     * The underlying type for the bitmask we use for tracking. This
+     * limits the number of snooping ports supported per crossbar.
+     */
+    typedef std::bitset<SNOOP_MASK_SIZE> SnoopMask;
+
+    /**
+     * Set of slave ports to snoop, a bitmask over the snooping ports
+     * of the filter. It can be iterated like a SnoopList, but doesn't
+     * need any allocation.
+     */
+    class SnoopTargets
     {
-    }
+      public:
+        class const_iterator
+        {
+          public:
+            const_iterator(const SnoopTargets &targets, size_t idx)
+                : targets(targets), idx(idx)
+            {
+                skip();
+            }
+
+            QueuedSlavePort *
+            operator*() const
+            {
+                return (*targets.ports)[idx];
+            }
+
+            const_iterator &
+            operator++()
+            {
+                ++idx;
+                skip();
+                return *this;
+            }
+
+            bool
+            operator!=(const const_iterator &other) const
+            {
+                return idx != other.idx;
+            }
+
+            bool
+            operator==(const const_iterator &other) const
+            {
+                return idx == other.idx;
+            }
+
+          private:
+            /** Move to the next port in the mask. */
+            void
+            skip()
+            {
+                while (idx < targets.ports->size() && !targets.mask[idx])
+                    ++idx;
+            }
+
+            const SnoopTargets &targets;
+            size_t idx;
+        };
+
+        SnoopTargets(const SnoopMask &mask, const SnoopList &ports)
+            : mask(mask), ports(&ports)
+        {}
+
+        const_iterator begin() const { return const_iterator(*this, 0); }
+        const_iterator
+        end() const
+        {
+            return const_iterator(*this, ports->size());
+        }
+
+        /** Are there no target ports? Consistent with size(). */
+        bool empty() const { return begin() == end(); }
+
+        /**
+         * Number of target ports. The snoop-all mask has bits set
+         * past the last port, so only the bits of real ports count.
+         */
+        size_t
+        size() const
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < ports->size(); ++i)
+                count += mask[i];
+            return count;
+        }
+
+      private:
+        SnoopMask mask;
+        const SnoopList *ports;
+    };
+
+    SnoopFilter (const SnoopFilterParams *p);
 
     /**
      * Init a new snoop filter and tell it about all the slave ports
@@ -134,10 +233,10 @@ class SnoopFilter : public SimObject {
      *
      * @param cpkt          Pointer to the request packet. Not changed.
      * @param slave_port    Slave port where the request came from.
-     * @return Pair of a vector of snoop target ports and lookup latency.
+     * @return Pair of the snoop target ports and lookup latency.
      */
-    std::pair<SnoopList, Cycles> lookupRequest(const Packet* cpkt,
-                                               const SlavePort& slave_port);
+    std::pair<SnoopTargets, Cycles> lookupRequest(const Packet* cpkt,
+                                                  const SlavePort& slave_port);
 
     /**
      * For an un-successful request, revert the change to the snoop
@@ -156,10 +255,10 @@ class SnoopFilter : public SimObject {
      * additional steering thanks to the snoop filter.
      *
      * @param cpkt Pointer to const Packet containing the snoop.
-     * @return Pair with a vector of SlavePorts that need snooping and a lookup
+     * @return Pair with the SlavePorts that need snooping and a lookup
      *         latency.
      */
-    std::pair<SnoopList, Cycles> lookupSnoop(const Packet* cpkt);
+    std::pair<SnoopTargets, Cycles> lookupSnoop(const Packet* cpkt);
 
     /**
      * Let the snoop filter see any snoop responses that turn into
@@ -201,12 +300,6 @@ class SnoopFilter : public SimObject {
 
   protected:
 
-    /**
-     * The underlying type for the bitmask we use for tracking. This
-     * limits the number of snooping ports supported per crossbar.
-     */
-    typedef std::bitset<SNOOP_MASK_SIZE> SnoopMask;
-
     /**
     * Per cache line item tracking a bitmask of SlavePorts who have an
     * outstanding request to this line (requested) or already share a
@@ -216,27 +309,32 @@ class SnoopFilter : public SimObject {
         SnoopMask requested;
         SnoopMask holder;
     };
-    /**
-     * HashMap of SnoopItems indexed by line address
-     */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+
+    /** A tracked line, invalid entries have the address MaxAddr. */
+    struct SnoopEntry {
+        /** Line address, including the LineStatus bits. */
+        Addr addr;
+        /** Last use of the entry, for LRU replacement. */
+        uint64_t lastUse;
+        SnoopItem item;
+    };
 
     /**
      * Simple factory methods for standard return values.
      */
-    std::pair<SnoopList, Cycles> snoopAll(Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopAll(Cycles latency) const
     {
-        return std::make_pair(slavePorts, latency);
+        return std::make_pair(SnoopTargets(SnoopMask().set(), slavePorts),
+                              latency);
     }
-    std::pair<SnoopList, Cycles> snoopSelected(const SnoopList& slave_ports,
-                                               Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopSelected(SnoopMask ports,
+                                                  Cycles latency) const
     {
-        return std::make_pair(slave_ports, latency);
+        return std::make_pair(SnoopTargets(ports, slavePorts), latency);
     }
-    std::pair<SnoopList, Cycles> snoopDown(Cycles latency) const
+    std::pair<SnoopTargets, Cycles> snoopDown(Cycles latency) const
     {
-        SnoopList empty;
-        return std::make_pair(empty , latency);
+        return std::make_pair(SnoopTargets(SnoopMask(), slavePorts), latency);
     }
 
     /**
@@ -245,22 +343,48 @@ class SnoopFilter : public SimObject {
      * @return One-hot bitmask corresponding to the port.
      */
     SnoopMask portToMask(const SlavePort& port) const;
+
+  private:
+
     /**
-     * Converts a bitmask of ports into the corresponing list of ports
-     * @param ports SnoopMask of the requested ports
-     * @return SnoopList containing all the requested SlavePorts
+     * Find the entry tracking a line. A line found in the overflow map
+     * is moved back into the array if its set has a free way.
+     *
+     * @param line_addr Line address, including the LineStatus bits.
+     * @return The entry or nullptr if the line isn't tracked.
      */
-    SnoopList maskToPortList(SnoopMask ports) const;
+    SnoopEntry *findEntry(Addr line_addr);
 
-  private:
+    /**
+     * Start tracking a line, replacing the LRU entry of its set that
+     * has no outstanding requests. The replaced entry is moved to the
+     * overflow map, as is the new line if no entry can be replaced.
+     *
+     * @param line_addr Line address, including the LineStatus bits.
+     * @return An empty entry for the line.
+     */
+    SnoopEntry *allocateEntry(Addr line_addr);
 
     /**
      * Removes snoop filter items which have no requesters and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
-
-    /** Simple hash set of cached addresses. */
-    SnoopFilterCache cachedLocations;
+    void eraseIfNullEntry(SnoopEntry *entry);
+
+    /** Number of lines currently tracked. */
+    size_t numEntries() const { return numValid + overflow.size(); }
+
+    /** Set-associative array of tracked lines, set after set. */
+    std::vector<SnoopEntry> entries;
+    /** Tracked lines that don't fit in their set, indexed by address. */
+    std::unordered_map<Addr, SnoopEntry> overflow;
+    /** Associativity of the array. */
+    const unsigned assoc;
+    /** Mask to get the set of a line number. */
+    const Addr setMask;
+    /** Number of valid entries in the array. */
+    size_t numValid;
+    /** Counter providing the LRU order of the entries. */
+    uint64_t useCount;
 
     /**
      * A request lookup must be followed by a call to finishRequest to inform
@@ -269,8 +393,8 @@ class SnoopFilter : public SimObject {
      * This structure keeps track of the state previous to such changes.
      */
     struct ReqLookupResult {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Entry used to store the result from lookupRequest. */
+        SnoopEntry *entry;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -279,17 +403,7 @@ class SnoopFilter : public SimObject {
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        ReqLookupResult() : entry(nullptr), retryItem{0, 0} {}
     } reqLookupResult;
 
     /** List of all attached snooping slave ports. */
@@ -298,6 +412,8 @@ class SnoopFilter : public SimObject {
     std::vector<PortID> localSlavePortIds;
     /** Cache line size. */
     const unsigned linesize;
+    /** Log2 of the cache line size. */
+    const int lineShift;
     /** Latency for doing a lookup in the filter */
     const Cycles lookupLatency;
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
@@ -319,6 +435,8 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar overflows;
 };
 
 inline SnoopFilter::SnoopMask
@@ -330,14 +448,4 @@ SnoopFilter::portToMask(const SlavePort& port) const
         ((SnoopMask)1) << localSlavePortIds[port.getId()];
 }
 
-inline SnoopFilter::SnoopList
-SnoopFilter::maskToPortList(SnoopMask port_mask) const
-{
-    SnoopList res;
-    for (const auto& p : slavePorts)
-        if ((port_mask & portToMask(*p)).any())
-            res.push_back(p);
-    return res;
-}
-
 #endif // __MEM_SNOOP_FILTER_HH__
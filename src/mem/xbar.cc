@@ -61,6 +61,7 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
       width(p->width),
+      portDecoder(InvalidPortID),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -81,6 +82,9 @@ BaseXBar::~BaseXBar()
 
     for (auto s: slavePorts)
         delete s;
+
+    for (auto r: freeRouteStates)
+        delete r;
 }
 
 Port &
@@ -332,10 +336,10 @@ BaseXBar::findPort(AddrRange addr_range)
     // ranges of all connected slave modules
     assert(gotAllAddrRanges);
 
-    // Check the address map interval tree
-    auto i = portMap.contains(addr_range);
-    if (i != portMap.end()) {
-        return i->second;
+    // Check the flat decoder compiled from the address map
+    const PortID port_id = portDecoder.find(addr_range);
+    if (port_id != InvalidPortID) {
+        return port_id;
     }
 
     // Check if this matches the default range
@@ -427,6 +431,8 @@ BaseXBar::recvRangeChange(PortID master_port_id)
                       masterPorts[conflict_id]->getPeer());
             }
         }
+
+        portDecoder.build(portMap);
     }
 
     // if we have received ranges from all our neighbouring slave
@@ -53,7 +53,9 @@
 
 #include <deque>
 #include <unordered_map>
+#include <vector>
 
+#include "base/addr_decoder.hh"
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
@@ -315,7 +317,13 @@ class BaseXBar : public ClockedObject
     /** the width of the xbar in bytes */
     const uint32_t width;
 
-    AddrRangeMap<PortID, 3> portMap;
+    AddrRangeMap<PortID> portMap;
+
+    /**
+     * Flat decoder compiled from portMap whenever the ranges change,
+     * used to find the destination of every packet.
+     */
+    AddrDecoder<PortID> portDecoder;
 
     /**
      * Remember where request packets came from so that we can route
@@ -325,6 +333,67 @@ class BaseXBar : public ClockedObject
      */
     std::unordered_map<RequestPtr, PortID> routeTo;
 
+    /**
+     * Sender state remembering the slave port a request came from,
+     * an alternative to routeTo for crossbars that only route
+     * responses to their own requests.
+     */
+    class RouteState : public Packet::SenderState
+    {
+      public:
+        PortID slavePortId;
+    };
+
+    /** Route states that are not in use, to avoid allocating them. */
+    std::vector<RouteState *> freeRouteStates;
+
+    /**
+     * Remember where a request came from by pushing a RouteState on
+     * the packet. This has to happen before the request is sent.
+     *
+     * @param pkt Request packet
+     * @param slave_port_id Id of the slave port the request came from
+     */
+    void
+    pushRoute(PacketPtr pkt, PortID slave_port_id)
+    {
+        RouteState *state;
+        if (freeRouteStates.empty()) {
+            state = new RouteState;
+        } else {
+            state = freeRouteStates.back();
+            freeRouteStates.pop_back();
+        }
+        state->slavePortId = slave_port_id;
+        pkt->pushSenderState(state);
+    }
+
+    /**
+     * Get the slave port a request came from, as remembered by
+     * pushRoute.
+     *
+     * @param pkt Request or response packet carrying the route
+     * @return Id of the slave port the request came from
+     */
+    static PortID
+    peekRoute(PacketPtr pkt)
+    {
+        return safe_cast<RouteState *>(pkt->senderState)->slavePortId;
+    }
+
+    /**
+     * Pop the RouteState pushed by pushRoute, either once the response
+     * is on its way or when the request could not be sent.
+     *
+     * @param pkt Packet carrying the route
+     */
+    void
+    popRoute(PacketPtr pkt)
+    {
+        freeRouteStates.push_back(
+            safe_cast<RouteState *>(pkt->popSenderState()));
+    }
+
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
 
@@ -39,12 +39,20 @@
 
 #include "proto/protoio.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+
 #include "base/logging.hh"
 
 using namespace std;
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const string& filename) :
+ProtoOutputStream::ProtoOutputStream(const string& filename, bool async) :
     fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
     wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
 {
@@ -64,8 +72,20 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
     }
 
     // Write the magic number to the file
-    io::CodedOutputStream codedStream(zeroCopyStream);
-    codedStream.WriteLittleEndian32(magicNumber);
+    if (async) {
+        // From now on the streams are only used by the writer thread
+        asyncWriter.reset(new AsyncWriter([this](const char* data,
+                                                 size_t size) {
+            writeRaw(data, size);
+        }, asyncBufferSize));
+
+        uint8_t magic[sizeof(magicNumber)];
+        io::CodedOutputStream::WriteLittleEndian32ToArray(magicNumber, magic);
+        asyncWriter->write(magic, sizeof(magic));
+    } else {
+        io::CodedOutputStream codedStream(zeroCopyStream);
+        codedStream.WriteLittleEndian32(magicNumber);
+    }
 
     // Note that each type of stream (packet, instruction etc) should
     // add its own header and perform the appropriate checks
@@ -73,6 +93,9 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    // Write out all buffered messages before closing the streams
+    asyncWriter.reset();
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL)
         delete gzipStream;
@@ -83,6 +106,22 @@ ProtoOutputStream::~ProtoOutputStream()
 void
 ProtoOutputStream::write(const Message& msg)
 {
+    if (asyncWriter) {
+        // Serialize the size and the message into the scratch buffer
+        // and leave the compression and file I/O to the writer thread
+        const uint32_t size = msg.ByteSize();
+        const size_t total = io::CodedOutputStream::VarintSize32(size) + size;
+        if (msgBuffer.size() < total)
+            msgBuffer.resize(total);
+
+        uint8_t* msg_start = msgBuffer.data();
+        msg_start = io::CodedOutputStream::WriteVarint32ToArray(size,
+                                                                msg_start);
+        msg.SerializeWithCachedSizesToArray(msg_start);
+        asyncWriter->write(msgBuffer.data(), total);
+        return;
+    }
+
     // Due to the byte limit of the coded stream we create it for
     // every single mesage (based on forum discussions around the size
     // limitation)
@@ -95,9 +134,23 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
+void
+ProtoOutputStream::flush()
+{
+    if (asyncWriter)
+        asyncWriter->flush();
+}
+
+void
+ProtoOutputStream::writeRaw(const char* data, size_t size)
+{
+    io::CodedOutputStream codedStream(zeroCopyStream);
+    codedStream.WriteRaw(data, size);
+}
+
 ProtoInputStream::ProtoInputStream(const string& filename) :
     fileStream(filename.c_str(), ios::in | ios::binary), fileName(filename),
-    useGzip(false),
+    useGzip(false), mappedData(NULL), mappedSize(0),
     wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
 {
     if (!fileStream.good())
@@ -112,9 +165,33 @@ ProtoInputStream::ProtoInputStream(const string& filename) :
     fileStream.clear();
     fileStream.seekg(0, ifstream::beg);
 
+    if (!useGzip)
+        mapFile();
+
     createStreams();
 }
 
+void
+ProtoInputStream::mapFile()
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // Fall back to the STL stream for anything but non-empty regular
+    // files, or if the mapping fails
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            mappedData = (const char*)addr;
+            mappedSize = st.st_size;
+        }
+    }
+    close(fd);
+}
+
 void
 ProtoInputStream::createStreams()
 {
@@ -125,7 +202,10 @@ ProtoInputStream::createStreams()
     // Wrap the input file in a zero copy stream, that in turn is
     // wrapped in a gzip stream if the filename ends with .gz. The
     // latter stream is in turn wrapped in a coded stream
-    wrappedFileStream = new io::IstreamInputStream(&fileStream);
+    if (mappedData != NULL)
+        wrappedFileStream = new MappedInputStream(mappedData, mappedSize);
+    else
+        wrappedFileStream = new io::IstreamInputStream(&fileStream);
     if (useGzip) {
         gzipStream = new io::GzipInputStream(wrappedFileStream);
         zeroCopyStream = gzipStream;
@@ -159,6 +239,8 @@ ProtoInputStream::destroyStreams()
 ProtoInputStream::~ProtoInputStream()
 {
     destroyStreams();
+    if (mappedData != NULL)
+        munmap((void*)mappedData, mappedSize);
     fileStream.close();
 }
 
@@ -199,3 +281,36 @@ ProtoInputStream::read(Message& msg)
 
     return false;
 }
+
+bool
+ProtoInputStream::MappedInputStream::Next(const void** buffer,
+                                          int* buffer_size)
+{
+    if (pos == size)
+        return false;
+
+    const size_t chunk = std::min(size - pos, (size_t)INT_MAX);
+    *buffer = data + pos;
+    *buffer_size = chunk;
+    pos += chunk;
+    return true;
+}
+
+void
+ProtoInputStream::MappedInputStream::BackUp(int count)
+{
+    assert(count >= 0 && (size_t)count <= pos);
+    pos -= count;
+}
+
+bool
+ProtoInputStream::MappedInputStream::Skip(int count)
+{
+    assert(count >= 0);
+    if ((size_t)count > size - pos) {
+        pos = size;
+        return false;
+    }
+    pos += count;
+    return true;
+}
@@ -51,7 +51,15 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/async_writer.hh"
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -98,9 +106,15 @@ class ProtoOutputStream : public ProtoStream
      * Create an output stream for a given file name. If the filename
      * ends with .gz then the file will be compressed accordinly.
      *
+     * In asynchronous mode, messages are serialized into large
+     * buffers that are compressed and written to the file by a
+     * background thread. Two buffers are used, so at most one buffer
+     * is waiting while the other one is filled.
+     *
      * @param filename Path to the file to create or truncate
+     * @param async Compress and write on a background thread
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename, bool async = false);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -116,8 +130,25 @@ class ProtoOutputStream : public ProtoStream
      */
     void write(const google::protobuf::Message& msg);
 
+    /**
+     * Wait until all messages written so far have been handed to the
+     * underlying streams.
+     */
+    void flush();
+
   private:
 
+    /// Size of each buffer in asynchronous mode
+    static const size_t asyncBufferSize = 4 << 20;
+
+    /**
+     * Write raw bytes to the top-level zero-copy stream.
+     *
+     * @param data Bytes to write
+     * @param size Number of bytes
+     */
+    void writeRaw(const char* data, size_t size);
+
     /// Underlying file output stream
     std::ofstream fileStream;
 
@@ -130,6 +161,12 @@ class ProtoOutputStream : public ProtoStream
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
+    /// Background writer, only used in asynchronous mode
+    std::unique_ptr<AsyncWriter> asyncWriter;
+
+    /// Scratch buffer messages are serialized into in asynchronous mode
+    std::vector<uint8_t> msgBuffer;
+
 };
 
 /**
@@ -138,6 +175,10 @@ class ProtoOutputStream : public ProtoStream
  * stream is done on a per-message basis to avoid having to deal with
  * huge data structures. The latter assumes the length of each message
  * is encoded in the stream when it is written.
+ *
+ * Uncompressed files are memory mapped when possible, so messages are
+ * parsed straight from the page cache without copying them through
+ * the STL stream.
  */
 class ProtoInputStream : public ProtoStream
 {
@@ -173,6 +214,32 @@ class ProtoInputStream : public ProtoStream
 
   private:
 
+    /**
+     * Zero-copy stream reading from a memory mapped file.
+     */
+    class MappedInputStream : public google::protobuf::io::ZeroCopyInputStream
+    {
+      public:
+        MappedInputStream(const char* _data, size_t _size)
+            : data(_data), size(_size), pos(0)
+        {}
+
+        bool Next(const void** buffer, int* buffer_size) override;
+        void BackUp(int count) override;
+        bool Skip(int count) override;
+        google::protobuf::int64 ByteCount() const override { return pos; }
+
+      private:
+        const char* const data;
+        const size_t size;
+        size_t pos;
+    };
+
+    /**
+     * Map the file into memory if it is a regular, uncompressed file.
+     */
+    void mapFile();
+
     /**
      * Create the internal streams that are wrapping the input file.
      */
@@ -192,8 +259,14 @@ class ProtoInputStream : public ProtoStream
     /// Boolean flag to remember whether we use gzip or not
     bool useGzip;
 
-    /// Zero Copy stream wrapping the STL input stream
-    google::protobuf::io::IstreamInputStream* wrappedFileStream;
+    /// Memory mapped file contents, if any
+    const char* mappedData;
+
+    /// Size of the memory mapped file
+    size_t mappedSize;
+
+    /// Zero Copy stream wrapping the mapped file or the STL input stream
+    google::protobuf::io::ZeroCopyInputStream* wrappedFileStream;
 
     /// Optional Gzip stream to wrap the Zero Copy stream
     google::protobuf::io::GzipInputStream* gzipStream;
@@ -203,4 +276,177 @@ class ProtoInputStream : public ProtoStream
 
 };
 
+/**
+ * A ProtoPrefetcher reads and parses messages of a single type from a
+ * ProtoInputStream ahead of their use on a helper thread. Messages are
+ * handed over in batches, so the threads only synchronise once per
+ * batch, and the number of batches in flight is bounded.
+ *
+ * The helper thread is started by the first read. Until then, and after
+ * a reset, the input stream may be used directly, e.g., to read a
+ * header.
+ */
+template <class Msg>
+class ProtoPrefetcher
+{
+
+  public:
+
+    /**
+     * @param _stream Input stream to read messages from
+     * @param batch_size Number of messages in a batch
+     * @param max_batches Number of parsed batches kept ahead
+     */
+    ProtoPrefetcher(ProtoInputStream& _stream, size_t batch_size = 1024,
+                    size_t max_batches = 4)
+        : stream(_stream), batchSize(batch_size), maxBatches(max_batches),
+          pos(0), started(false), eof(false), stopping(false)
+    {}
+
+    ~ProtoPrefetcher() { stop(); }
+
+    /**
+     * Read the next message.
+     *
+     * @param msg Message read from the stream
+     * @return True if a message was read, false at the end of the stream
+     */
+    bool
+    read(Msg& msg)
+    {
+        if (pos == current.size()) {
+            if (!started) {
+                started = true;
+                helper = std::thread(&ProtoPrefetcher::prefetch, this);
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!current.empty())
+                freeBatches.push_back(std::move(current));
+            current.clear();
+            pos = 0;
+            filled.wait(lock, [this] { return !batches.empty() || eof; });
+            if (batches.empty())
+                return false;
+
+            current = std::move(batches.front());
+            batches.pop_front();
+            pos = 0;
+            consumed.notify_one();
+        }
+
+        msg.Swap(&current[pos++]);
+        return true;
+    }
+
+    /**
+     * Stop prefetching and reset the input stream to the beginning of
+     * the file.
+     */
+    void
+    reset()
+    {
+        stop();
+        stream.reset();
+    }
+
+  private:
+
+    /// Stop the helper thread and drop all prefetched messages
+    void
+    stop()
+    {
+        if (!started)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        consumed.notify_one();
+        helper.join();
+
+        batches.clear();
+        current.clear();
+        pos = 0;
+        started = false;
+        eof = false;
+        stopping = false;
+    }
+
+    /// Body of the helper thread
+    void
+    prefetch()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            consumed.wait(lock, [this] {
+                return batches.size() < maxBatches || stopping;
+            });
+            if (stopping)
+                return;
+
+            std::vector<Msg> batch;
+            if (!freeBatches.empty()) {
+                batch = std::move(freeBatches.back());
+                freeBatches.pop_back();
+            }
+            lock.unlock();
+
+            batch.resize(batchSize);
+            size_t num_read = 0;
+            while (num_read < batchSize && stream.read(batch[num_read]))
+                ++num_read;
+            batch.resize(num_read);
+
+            lock.lock();
+            if (num_read > 0)
+                batches.push_back(std::move(batch));
+            if (num_read < batchSize) {
+                eof = true;
+                filled.notify_one();
+                return;
+            }
+            filled.notify_one();
+        }
+    }
+
+    /// Stream the messages are read from
+    ProtoInputStream& stream;
+
+    const size_t batchSize;
+    const size_t maxBatches;
+
+    /// Batch being consumed and the position of the next message in it
+    std::vector<Msg> current;
+    size_t pos;
+
+    /// Has the helper thread been started?
+    bool started;
+
+    std::thread helper;
+
+    /// Protects everything below
+    std::mutex mutex;
+
+    /// Signalled when a batch is added or the end of the stream reached
+    std::condition_variable filled;
+
+    /// Signalled when a batch is taken or the helper should stop
+    std::condition_variable consumed;
+
+    /// Parsed batches waiting to be consumed
+    std::deque<std::vector<Msg>> batches;
+
+    /// Consumed batches whose messages can be reused
+    std::vector<std::vector<Msg>> freeBatches;
+
+    /// Has the helper thread reached the end of the stream?
+    bool eof;
+
+    /// Should the helper thread stop?
+    bool stopping;
+
+};
+
 #endif //__PROTO_PROTOIO_HH
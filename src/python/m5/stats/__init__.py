@@ -197,6 +197,30 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "bin", ])
+def _binaryFactory(fn, delta=True):
+    """Output stats in a binary columnar format.
+
+    The stat layout (names and column labels) is written once, every
+    dump then appends a single packed record of raw values. This makes
+    frequent periodic dumps much cheaper than text stats. Use
+    m5.stats.binary.BinaryStats (which works without gem5) to read the
+    file.
+
+    Known limitations:
+      * Vector distributions and sparse histograms currently unsupported.
+
+    Parameters:
+      * delta (bool): Store integral values as varint encoded deltas
+                      to the previous dump (default: True)
+
+    Example:
+      bin://stats.bin?delta=False
+
+    """
+
+    return _m5.stats.initBinary(fn, delta)
+
 def addStatVisitor(url):
     """Add a stat visitor specified using a URL string
 
@@ -0,0 +1,205 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for binary stat files written by the bin:// stat visitor.
+
+This module doesn't depend on gem5 and can be used as a script or
+copied into analysis flows:
+
+    python binary.py stats.bin [stat ...]
+
+    stats = BinaryStats("m5out/stats.bin")
+    ticks = stats.ticks
+    ipc = stats.column("system.cpu.ipc")
+    for tick, values in stats.dumps():
+        ...
+
+Columns of scalars are named after the stat, columns of vectors,
+formulas, 2d vectors and distributions are named "<stat>::<label>".
+"""
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import struct
+
+MAGIC = b"gem5stat"
+VERSION = 1
+
+SCHEMA_BLOCK = b"S"
+RECORD_BLOCK = b"R"
+
+KINDS = ( "scalar", "vector", "dist", "vector2d", "formula" )
+
+class Stat(object):
+    def __init__(self, kind, name, labels):
+        self.kind = KINDS[kind]
+        self.name = name
+        self.labels = labels
+
+    def columns(self):
+        if self.kind == "scalar":
+            return [ self.name ]
+        return [ "%s::%s" % (self.name, l) for l in self.labels ]
+
+class _Buffer(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+    def unpack(self, fmt):
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return values
+
+    def byte(self):
+        b = self.data[self.pos:self.pos + 1]
+        self.pos += 1
+        return b
+
+    def string(self):
+        size, = self.unpack("<I")
+        s = self.data[self.pos:self.pos + size].decode("utf-8")
+        self.pos += size
+        return s
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = ord(self.data[self.pos:self.pos + 1])
+            self.pos += 1
+            value |= (b & 0x7f) << shift
+            if b < 0x80:
+                return value
+            shift += 7
+
+class BinaryStats(object):
+    """All dumps of a binary stat file.
+
+    Attributes:
+        ticks: Tick of every dump.
+        schemas: List of (first dump index, list of Stat) for every
+                 layout found in the file.
+    """
+
+    def __init__(self, fn):
+        with open(fn, "rb") as f:
+            buf = _Buffer(f.read())
+
+        if buf.data[:len(MAGIC)] != MAGIC:
+            raise ValueError("%s: not a binary stat file" % fn)
+        buf.pos = len(MAGIC)
+        version, delta = buf.unpack("<IB")
+        if version != VERSION:
+            raise ValueError("%s: unsupported version %d" % (fn, version))
+
+        self.ticks = []
+        self.schemas = []
+        self._records = []
+
+        columns = []
+        last = []
+        while not buf.done():
+            block = buf.byte()
+            if block == SCHEMA_BLOCK:
+                stats = []
+                num_stats, = buf.unpack("<I")
+                for i in range(num_stats):
+                    kind, = buf.unpack("<B")
+                    name = buf.string()
+                    num_labels, = buf.unpack("<I")
+                    labels = [ buf.string() for l in range(num_labels) ]
+                    stats.append(Stat(kind, name, labels))
+                columns = [ c for s in stats for c in s.columns() ]
+                last = [ 0 ] * len(columns)
+                self.schemas.append((len(self.ticks), stats))
+            elif block == RECORD_BLOCK:
+                tick, count = buf.unpack("<QI")
+                if count != len(columns):
+                    raise ValueError("%s: record doesn't match schema" % fn)
+                if delta:
+                    values = []
+                    for prev in last:
+                        v = buf.varint()
+                        if v & 1:
+                            values.append(buf.unpack("<d")[0])
+                        else:
+                            zigzag = v >> 1
+                            diff = (zigzag >> 1) ^ -(zigzag & 1)
+                            values.append(float(int(prev) + diff))
+                else:
+                    values = list(buf.unpack("<%dd" % count))
+                last = values
+                self.ticks.append(tick)
+                self._records.append((columns, values))
+            else:
+                raise ValueError("%s: corrupt block at offset %d" % \
+                                 (fn, buf.pos - 1))
+
+    def __len__(self):
+        return len(self.ticks)
+
+    def dumps(self):
+        """Iterate over (tick, {column: value}) for every dump."""
+        for tick, (columns, values) in zip(self.ticks, self._records):
+            yield tick, dict(zip(columns, values))
+
+    def columns(self):
+        """Names of all columns found in the file."""
+        names = []
+        seen = set()
+        for first, stats in self.schemas:
+            for c in [ c for s in stats for c in s.columns() ]:
+                if c not in seen:
+                    seen.add(c)
+                    names.append(c)
+        return names
+
+    def column(self, name):
+        """Values of a column for every dump, None where it is absent."""
+        result = []
+        index = {}
+        for columns, values in self._records:
+            if id(columns) not in index:
+                index[id(columns)] = \
+                    columns.index(name) if name in columns else None
+            i = index[id(columns)]
+            result.append(values[i] if i is not None else None)
+        return result
+
+if __name__ == "__main__":
+    import sys
+
+    if len(sys.argv) < 2:
+        print("usage: %s FILE [COLUMN ...]" % sys.argv[0])
+        sys.exit(1)
+
+    stats = BinaryStats(sys.argv[1])
+    names = sys.argv[2:] or stats.columns()
+    print("tick", *names, sep="\t")
+    for tick, row in stats.dumps():
+        print(tick, *[ repr(row.get(n)) for n in names ], sep="\t")
@@ -74,7 +74,6 @@ using namespace std;
 int Serializable::ckptMaxCount = 0;
 int Serializable::ckptCount = 0;
 int Serializable::ckptPrevCount = -1;
-std::stack<std::string> Serializable::path;
 
 /////////////////////////////
 
@@ -164,28 +163,6 @@ Globals::unserialize(CheckpointIn &cp)
      }
 }
 
-Serializable::Serializable()
-{
-}
-
-Serializable::~Serializable()
-{
-}
-
-void
-Serializable::serializeSection(CheckpointOut &cp, const char *name) const
-{
-    Serializable::ScopedCheckpointSection sec(cp, name);
-    serialize(cp);
-}
-
-void
-Serializable::unserializeSection(CheckpointIn &cp, const char *name)
-{
-    Serializable::ScopedCheckpointSection sec(cp, name);
-    unserialize(cp);
-}
-
 void
 Serializable::serializeAll(const string &cpt_dir)
 {
@@ -240,18 +217,6 @@ Serializable::ScopedCheckpointSection::nameOut(CheckpointOut &cp)
     cp << "\n[" << Serializable::currentSection() << "]\n";
 }
 
-const std::string &
-Serializable::currentSection()
-{
-    assert(!path.empty());
-
-    return path.top();
-}
-
-const char *CheckpointIn::baseFilename = "m5.cpt";
-
-string CheckpointIn::currentDirectory;
-
 string
 CheckpointIn::setDir(const string &name)
 {
@@ -264,38 +229,6 @@ CheckpointIn::setDir(const string &name)
     return currentDirectory;
 }
 
-string
-CheckpointIn::dir()
-{
-    return currentDirectory;
-}
-
-CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
-    : db(new IniFile), objNameResolver(resolver), cptDir(setDir(cpt_dir))
-{
-    string filename = cptDir + "/" + CheckpointIn::baseFilename;
-    if (!db->load(filename)) {
-        fatal("Can't load checkpoint file '%s'\n", filename);
-    }
-}
-
-CheckpointIn::~CheckpointIn()
-{
-    delete db;
-}
-
-bool
-CheckpointIn::entryExists(const string &section, const string &entry)
-{
-    return db->entryExists(section, entry);
-}
-
-bool
-CheckpointIn::find(const string &section, const string &entry, string &value)
-{
-    return db->find(section, entry, value);
-}
-
 bool
 CheckpointIn::findObj(const string &section, const string &entry,
                     SimObject *&value)
@@ -309,12 +242,6 @@ CheckpointIn::findObj(const string &section, const string &entry,
     return true;
 }
 
-bool
-CheckpointIn::sectionExists(const string &section)
-{
-    return db->sectionExists(section);
-}
-
 void
 objParamIn(CheckpointIn &cp, const string &name, SimObject * &param)
 {
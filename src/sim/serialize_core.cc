@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2015 ARM Limited
+ * All rights reserved
+ *
+ * The license below extends only to copyright in the software and shall
+ * not be construed as granting a license to any other intellectual
+ * property including but not limited to intellectual property relating
+ * to a hardware implementation of the functionality of the software
+ * licensed hereunder.  You may use the software subject to the license
+ * terms below provided that you ensure that this notice is replicated
+ * unmodified and in its entirety in all distributions of the software,
+ * modified or unmodified, in source code or in binary form.
+ *
+ * Copyright (c) 2002-2005 The Regents of The University of Michigan
+ * Copyright (c) 2013 Advanced Micro Devices, Inc.
+ * Copyright (c) 2013 Mark D. Hill and David A. Wood
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Nathan Binkert
+ *          Erik Hallnor
+ *          Steve Reinhardt
+ *          Andreas Sandberg
+ */
+
+/*
+ * The parts of the checkpointing core that only depend on the ini file
+ * parser. They are shared between the simulator and unit tests of
+ * Serializable objects; sim/serialize.cc and base/gtest/serialize.cc
+ * provide the section bookkeeping and the checkpoint directory naming.
+ */
+
+#include <cassert>
+#include <string>
+
+#include "base/inifile.hh"
+#include "base/logging.hh"
+#include "sim/serialize.hh"
+
+using namespace std;
+
+std::stack<std::string> Serializable::path;
+
+Serializable::Serializable()
+{
+}
+
+Serializable::~Serializable()
+{
+}
+
+void
+Serializable::serializeSection(CheckpointOut &cp, const char *name) const
+{
+    Serializable::ScopedCheckpointSection sec(cp, name);
+    serialize(cp);
+}
+
+void
+Serializable::unserializeSection(CheckpointIn &cp, const char *name)
+{
+    Serializable::ScopedCheckpointSection sec(cp, name);
+    unserialize(cp);
+}
+
+const std::string &
+Serializable::currentSection()
+{
+    assert(!path.empty());
+
+    return path.top();
+}
+
+const char *CheckpointIn::baseFilename = "m5.cpt";
+
+string CheckpointIn::currentDirectory;
+
+string
+CheckpointIn::dir()
+{
+    return currentDirectory;
+}
+
+CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
+    : db(new IniFile), objNameResolver(resolver), cptDir(setDir(cpt_dir))
+{
+    string filename = cptDir + "/" + CheckpointIn::baseFilename;
+    if (!db->load(filename)) {
+        fatal("Can't load checkpoint file '%s'\n", filename);
+    }
+}
+
+CheckpointIn::~CheckpointIn()
+{
+    delete db;
+}
+
+bool
+CheckpointIn::entryExists(const string &section, const string &entry)
+{
+    return db->entryExists(section, entry);
+}
+
+bool
+CheckpointIn::find(const string &section, const string &entry, string &value)
+{
+    return db->find(section, entry, value);
+}
+
+bool
+CheckpointIn::sectionExists(const string &section)
+{
+    return db->sectionExists(section);
+}
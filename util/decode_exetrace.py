@@ -0,0 +1,214 @@
+#!/usr/bin/env python
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Decoder for binary instruction traces written by the BinaryExeTracer.
+# It prints the same text the ExeTracer would have printed with the
+# debug flags that were enabled when each instruction was traced:
+#
+#   decode_exetrace.py m5out/system.cpu.tracer.bin [output]
+#
+# Compressed traces (.gz) are decompressed on the fly.
+
+from __future__ import print_function
+
+import gzip
+import struct
+import sys
+
+MAGIC = b"gem5exec"
+VERSION = 1
+
+CPU_BLOCK = b"C"
+INST_BLOCK = b"D"
+RECORD_BLOCK = b"I"
+
+RECORD = struct.Struct("<BBBBHHHHI7Q")
+
+# Format flags
+FMT_ASID = 1 << 0
+FMT_THREAD = 1 << 1
+FMT_OP_CLASS = 1 << 2
+FMT_RESULT = 1 << 3
+FMT_EFF_ADDR = 1 << 4
+FMT_FETCH_SEQ = 1 << 5
+FMT_CP_SEQ = 1 << 6
+FMT_INST_FLAGS = 1 << 7
+FMT_TICKS_OFF = 1 << 8
+FMT_FLAG = 1 << 9
+
+# Status flags
+RAN = 1 << 0
+PREDICATE = 1 << 1
+MEM_VALID = 1 << 2
+FETCH_SEQ_VALID = 1 << 3
+CP_SEQ_VALID = 1 << 4
+MICROOP = 1 << 5
+USE_SYMBOL = 1 << 6
+
+DATA_INVALID = 0
+DATA_VEC = 5
+DATA_VEC_PRED = 6
+
+class TraceError(Exception):
+    pass
+
+class Reader(object):
+    def __init__(self, f):
+        self.f = f
+
+    def read(self, size):
+        data = self.f.read(size)
+        if len(data) != size:
+            raise TraceError("truncated trace")
+        return data
+
+    def u32(self):
+        return struct.unpack("<I", self.read(4))[0]
+
+    def string(self):
+        return self.read(self.u32()).decode("utf-8")
+
+def open_trace(fn):
+    with open(fn, "rb") as f:
+        compressed = f.read(2) == b"\x1f\x8b"
+    return gzip.open(fn, "rb") if compressed else open(fn, "rb")
+
+def format_record(r, insts, cpus, op_classes, vec_data):
+    (type_, status, op_class, data_status, cpu, thread, micro_pc, fmt,
+     inst, tick, pc, asid, data, addr, fetch_seq, cp_seq) = r
+    disasm, symbol, flags = insts[inst]
+
+    out = []
+    if not fmt & FMT_TICKS_OFF:
+        out.append("%7d: " % tick)
+    if fmt & FMT_FLAG:
+        out.append("ExecEnable: ")
+    out.append("%s: " % cpus[cpu])
+
+    if fmt & FMT_ASID:
+        out.append("A%d " % asid)
+    if fmt & FMT_THREAD:
+        out.append("T%d : " % thread)
+
+    if status & USE_SYMBOL and symbol:
+        out.append(symbol)
+    else:
+        out.append("0x%x" % pc)
+
+    if status & MICROOP:
+        out.append(".%2d" % micro_pc)
+    else:
+        out.append("   ")
+    out.append(" : ")
+    out.append("%-26s" % disasm)
+
+    if status & RAN:
+        out.append(" : ")
+
+        if fmt & FMT_OP_CLASS:
+            out.append("%s : " % op_classes[op_class])
+
+        if fmt & FMT_RESULT and not status & PREDICATE:
+            out.append("Predicated False")
+
+        if fmt & FMT_RESULT and data_status != DATA_INVALID:
+            if data_status == DATA_VEC:
+                out.append(" D=0x[%s]" % "_".join(
+                    "%08x" % w for w in reversed(vec_data)))
+            elif data_status == DATA_VEC_PRED:
+                bits = []
+                for i in reversed(range(len(vec_data))):
+                    bits.append("1" if vec_data[i] else "0")
+                    if i != 0 and i % 4 == 0:
+                        bits.append("_")
+                out.append(" D=0b[%s]" % "".join(bits))
+            else:
+                out.append(" D=0x%016x" % data)
+
+        if fmt & FMT_EFF_ADDR and status & MEM_VALID:
+            out.append(" A=0x%x" % addr)
+
+        if fmt & FMT_FETCH_SEQ and status & FETCH_SEQ_VALID:
+            out.append("  FetchSeq=%d" % fetch_seq)
+
+        if fmt & FMT_CP_SEQ and status & CP_SEQ_VALID:
+            out.append("  CPSeq=%d" % cp_seq)
+
+        if fmt & FMT_INST_FLAGS:
+            out.append("  flags=(%s)" % flags)
+
+    out.append("\n")
+    return "".join(out)
+
+def decode(f, out):
+    r = Reader(f)
+    if r.read(len(MAGIC)) != MAGIC:
+        raise TraceError("not a binary instruction trace")
+    version, vec_bytes, vec_pred_bits, num_op_classes = \
+        struct.unpack("<4I", r.read(16))
+    if version != VERSION:
+        raise TraceError("unsupported version %d" % version)
+    op_classes = [ r.string() for i in range(num_op_classes) ]
+
+    vec = struct.Struct("<%dI" % (vec_bytes // 4))
+    cpus = []
+    insts = []
+    while True:
+        block = f.read(1)
+        if not block:
+            break
+        if block == RECORD_BLOCK:
+            record = RECORD.unpack(block + r.read(RECORD.size - 1))
+            data_status = record[3]
+            if data_status == DATA_VEC:
+                vec_data = vec.unpack(r.read(vec.size))
+            elif data_status == DATA_VEC_PRED:
+                vec_data = bytearray(r.read(vec_pred_bits))
+            else:
+                vec_data = None
+            out.write(format_record(record, insts, cpus, op_classes,
+                                    vec_data))
+        elif block == INST_BLOCK:
+            insts.append((r.string(), r.string(), r.string()))
+        elif block == CPU_BLOCK:
+            cpus.append(r.string())
+        else:
+            raise TraceError("corrupt block at offset %d" % (f.tell() - 1))
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print("Usage: %s <binary trace> [text output]" % sys.argv[0])
+        sys.exit(1)
+
+    out = open(sys.argv[2], "w") if len(sys.argv) == 3 else sys.stdout
+    try:
+        with open_trace(sys.argv[1]) as f:
+            decode(f, out)
+    except TraceError as e:
+        print("%s: %s" % (sys.argv[1], e), file=sys.stderr)
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()